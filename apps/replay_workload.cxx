@@ -0,0 +1,229 @@
+/**
+ * @file replay_workload.cxx - replay a logging workload recorded with
+ *                             DUNEDAQ_LOGGING_RECORD (see logging/detail/Recorder.hxx)
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option] <record_file>   # replay a recorded logging workload
+example: DUNEDAQ_ERS_WARNING='erstrace,throttle(10,50),lstderr' %s /tmp/logging_workload_1234.rec 2>/dev/null
+options:
+ --help, -h       - print this help
+ --speed, -s      - time scale factor (2 = replay twice as fast)
+ --no-sleep, -n   - do not reproduce the timing; replay as fast as possible
+The recorded messages are reproduced (same severity/level and message size) by
+one thread per recorded thread under the current DUNEDAQ_ERS_* and TRACE
+configuration.  The latency of each call, the lateness with respect to the
+recorded timing and, per severity, the fraction of the messages which did not
+reach the end of the ERS destination chain (e.g. throttled) are reported.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <unistd.h>             // usleep
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>              // memcmp
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <logging/Logging.hpp>
+
+ERS_DECLARE_ISSUE(ERS_EMPTY,                        // namespace ERS_EMPTY ==> anonymous
+                  ReplayIssue,                      // issue class name
+                  text,
+                  ((std::string)text)
+                  )
+
+using dunedaq::logging::WorkloadHeader;
+using dunedaq::logging::WorkloadRecord;
+using dunedaq::logging::Recorder;
+using steady = std::chrono::steady_clock;
+
+// indexed by ers::severity (Debug ... Fatal)
+static const char *g_sev_names[] = {"debug","log","info","warning","error","fatal"};
+static std::atomic<uint64_t> g_delivered[6];
+
+// Counts the issues reaching the end of the chain
+struct replaycountStream : public ers::OutputStream {
+	void write( const ers::Issue & issue )
+	{
+		int idx=static_cast<int>(issue.severity().type);
+		++g_delivered[(idx<0)?0:(idx>5)?5:idx];
+		chained().write( issue );
+	}
+};
+LOGGING_REGISTER_OUTPUT_STREAM( replaycountStream, "replaycount", ERS_EMPTY, replaycount )
+
+static int sev_index( uint8_t lvl )
+{
+	switch (lvl) {
+	case TLVL_FATAL:   return ers::Fatal;
+	case TLVL_ERROR:   return ers::Error;
+	case TLVL_WARNING: return ers::Warning;
+	case TLVL_INFO:    return ers::Information;
+	case TLVL_LOG:     return ers::Log;
+	default:           return ers::Debug;
+	}
+}
+
+struct ThreadResult
+{
+	std::vector<uint64_t> latency_ns[6];
+	uint64_t              issued[6] = {};
+	uint64_t              max_late_ns = 0;
+};
+
+static void replay_thread( const std::atomic<int> *spinlock, const steady::time_point *t0p,
+                           const std::vector<WorkloadRecord> *recs, double speed, bool do_sleep, ThreadResult *res )
+{
+	std::string text( 0x10000, 'x' );	// rr.size is at most 0xffff; text[rr.size] is the terminator
+	for (auto &lv : res->latency_ns)
+		lv.reserve( recs->size() );
+
+	while(spinlock->load(std::memory_order_acquire));	// The main program thread will clear this
+								// once all thread are created and given a
+								// chance to get here.
+	for (const WorkloadRecord &rr : *recs) {
+		steady::time_point sched = *t0p + std::chrono::nanoseconds( static_cast<uint64_t>(rr.ns/speed) );
+		if (do_sleep)
+			std::this_thread::sleep_until( sched );
+		steady::time_point t1 = steady::now();
+		text[rr.size] = '\0';
+		const char *msg = text.c_str();
+		if (rr.source == Recorder::k_verstrace) {
+			if (rr.lvl < TLVL_DEBUG) TLOG()                          << msg;
+			else                     TLOG_DEBUG(rr.lvl-TLVL_DEBUG) << msg;
+		} else {
+			ReplayIssue iss( ERS_HERE, std::string(msg,rr.size) );
+			switch (rr.lvl) {
+			case TLVL_FATAL:   ers::fatal(   iss ); break;
+			case TLVL_ERROR:   ers::error(   iss ); break;
+			case TLVL_WARNING: ers::warning( iss ); break;
+			case TLVL_INFO:    ers::info(    iss ); break;
+			case TLVL_LOG:     ers::log(     iss ); break;
+			default:           ers::debug(   iss, rr.lvl-TLVL_DEBUG ); break;
+			}
+		}
+		steady::time_point t2 = steady::now();
+		text[rr.size] = 'x';
+		int si = sev_index( rr.lvl );
+		++res->issued[si];
+		res->latency_ns[si].push_back( std::chrono::duration_cast<std::chrono::nanoseconds>(t2-t1).count() );
+		if (do_sleep && t1 > sched) {
+			uint64_t late = std::chrono::duration_cast<std::chrono::nanoseconds>(t1-sched).count();
+			if (late > res->max_late_ns) res->max_late_ns = late;
+		}
+	}
+}
+
+static double pct_us( std::vector<uint64_t> &vv, double pct )
+{
+	if (vv.empty()) return 0.0;
+	size_t idx = static_cast<size_t>(pct/100.0*(vv.size()-1));
+	std::nth_element( vv.begin(), vv.begin()+idx, vv.end() );
+	return vv[idx]/1000.0;
+}
+
+
+int main(int argc, char *argv[])
+{
+	double speed=1.0;
+	int opt_help=0, do_sleep=1;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "speed",    required_argument, nullptr,   's' },
+			{ "no-sleep", no_argument,       nullptr,   'n' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hs:n",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                          break;
+		case 's':           speed   =strtod(optarg,nullptr);     break;
+		case 'n':           do_sleep=0;                          break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help || optind != argc-1 || speed <= 0.0) { USAGE(); exit(opt_help?0:1); }
+
+	FILE *fp=fopen( argv[optind], "rb" );
+	WorkloadHeader hdr;
+	if (!fp || fread(&hdr,sizeof(hdr),1,fp) != 1 || memcmp(hdr.magic,"DDLOGREC",8) != 0
+	    || hdr.record_size != sizeof(WorkloadRecord)) {
+		fprintf( stderr, "%s: not a (compatible) logging workload record file\n", argv[optind] );
+		exit(1);
+	}
+	std::map<uint32_t,std::vector<WorkloadRecord>> per_tid;
+	WorkloadRecord rr;
+	size_t nrecs=0;
+	while (fread(&rr,sizeof(rr),1,fp) == 1) {
+		per_tid[rr.tid].push_back( rr );
+		++nrecs;
+	}
+	fclose( fp );
+	for (auto &pt : per_tid)
+		std::sort( pt.second.begin(), pt.second.end(),
+		           [](const WorkloadRecord &aa, const WorkloadRecord &bb) { return aa.ns < bb.ns; } );
+
+	// count what reaches the end of each chain; same defaults as Logging::setup()
+	unsetenv( "DUNEDAQ_LOGGING_RECORD" );
+	const char *chains[][2] = { {"DUNEDAQ_ERS_FATAL",  "erstrace,lstderr"},
+	                            {"DUNEDAQ_ERS_ERROR",  "erstrace,throttle(30,100),lstderr"},
+	                            {"DUNEDAQ_ERS_WARNING","erstrace,throttle(30,100),lstderr"},
+	                            {"DUNEDAQ_ERS_INFO",   "erstrace,lstdout"},
+	                            {"DUNEDAQ_ERS_LOG",    "lstdout"},
+	                            {"DUNEDAQ_ERS_DEBUG",  "lstdout"} };
+	for (auto &ch : chains) {
+		const char *cp = getenv( ch[0] );
+		std::string val = std::string( (cp && *cp) ? cp : ch[1] ) + ",replaycount";
+		setenv( ch[0], val.c_str(), 1 );
+	}
+	dunedaq::logging::Logging::setup("test", "replay_workload");
+	for (auto &dd : g_delivered)
+		dd = 0;
+
+	std::vector<ThreadResult> results( per_tid.size() );
+	std::vector<std::thread>  threads;
+	steady::time_point t0;
+	std::atomic<int> spinlock{1};
+	size_t ti=0;
+	for (auto &pt : per_tid)
+		threads.emplace_back( replay_thread, &spinlock, &t0, &pt.second, speed, do_sleep!=0, &results[ti++] );
+
+	usleep(20000);
+	t0 = steady::now() + std::chrono::milliseconds(1);
+	spinlock.store( 0, std::memory_order_release );	// publishes t0
+	for (std::thread& tt : threads)
+		tt.join();
+	double secs = std::chrono::duration<double>(steady::now()-t0).count();
+
+	ThreadResult tot;
+	for (ThreadResult &res : results) {
+		for (int si=0; si<6; ++si) {
+			tot.issued[si] += res.issued[si];
+			tot.latency_ns[si].insert( tot.latency_ns[si].end(), res.latency_ns[si].begin(), res.latency_ns[si].end() );
+		}
+		tot.max_late_ns = std::max( tot.max_late_ns, res.max_late_ns );
+	}
+	fprintf( stderr, "replayed %zu records of %zu threads in %.3f s = %.0f msgs/s (max lateness %.1f us)\n",
+	         nrecs, per_tid.size(), secs, nrecs/secs, tot.max_late_ns/1000.0 );
+	fprintf( stderr, "%-8s %10s %10s %7s %10s %10s %10s\n", "severity", "issued", "delivered", "drop%", "p50_us", "p99_us", "max_us" );
+	for (int si=5; si>=0; --si) {
+		if (!tot.issued[si]) continue;
+		uint64_t dlv = g_delivered[si];
+		fprintf( stderr, "%-8s %10lu %10lu %7.2f %10.2f %10.2f %10.2f\n", g_sev_names[si],
+		         static_cast<unsigned long>(tot.issued[si]), static_cast<unsigned long>(dlv),
+		         (dlv<tot.issued[si]) ? 100.0*(tot.issued[si]-dlv)/tot.issued[si] : 0.0,
+		         pct_us(tot.latency_ns[si],50), pct_us(tot.latency_ns[si],99), pct_us(tot.latency_ns[si],100) );
+	}
+	return (0);
+}   // main
@@ -0,0 +1,131 @@
+/**
+ * @file tshow_join.cxx - reassemble the continuation records of long messages
+ *                        (see logging/detail/Continuation.hxx) in tshow output
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: tshow | %s [option]   # join "~<id>:<k>/<n>~" continuation records
+example: tshow | tdelta -ct 1 | %s
+options:
+ --help, -h       - print this help
+Lines without a continuation prefix are passed through.  A joined message is
+printed when its last chunk is read, using the tshow columns of chunk 1.
+Incomplete messages (e.g. chunks overwritten in the circular buffer) are printed
+at the end with the missing chunks marked.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Pending
+{
+	std::string              columns;		// the tshow columns of chunk 1
+	std::vector<std::string> parts;
+	std::vector<bool>        new_line;
+	std::vector<bool>        have;
+	size_t                   received = 0;
+};
+
+// more chunks than split_chunks() makes of a 64 KiB message (one per byte) are
+// taken to be text which only looks like a marker
+static const size_t k_max_chunks = 0x10000;
+
+// "~<hex id>:<k>/<n>[+]~"; returns the position of the marker or npos
+static size_t parse_marker( const std::string &line, unsigned long *id, size_t *kk, size_t *nn, bool *nl, size_t *after )
+{
+	for (size_t pos=line.find('~'); pos!=std::string::npos; pos=line.find('~',pos+1)) {
+		const char *bb = line.c_str()+pos+1;
+		char *ep;
+		*id = strtoul( bb, &ep, 16 );
+		if (ep == bb || *ep != ':') continue;
+		bb = ep+1;
+		*kk = strtoul( bb, &ep, 10 );
+		if (ep == bb || *ep != '/') continue;
+		bb = ep+1;
+		*nn = strtoul( bb, &ep, 10 );
+		if (ep == bb) continue;
+		*nl = (*ep == '+');
+		if (*nl) ++ep;
+		if (*ep != '~' || *kk == 0 || *kk > *nn || *nn > k_max_chunks) continue;
+		*after = static_cast<size_t>(ep+1-line.c_str());
+		return pos;
+	}
+	return std::string::npos;
+}
+
+static void print( const Pending &pp )
+{
+	std::string out = pp.columns;
+	for (size_t kk=0; kk<pp.parts.size(); ++kk) {
+		if (kk && pp.new_line[kk]) out += '\n';
+		if (pp.have[kk]) out += pp.parts[kk];
+		else             out += "[missing " + std::to_string(kk+1) + "/" + std::to_string(pp.parts.size()) + "]";
+	}
+	std::cout << out << '\n';
+}
+
+
+int main(int argc, char *argv[])
+{
+	int opt_help=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?h",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1; break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help || optind != argc) { USAGE(); exit(opt_help?0:1); }
+
+	std::map<unsigned long,Pending> pending;
+	std::string line;
+	while (std::getline(std::cin,line)) {
+		unsigned long id;
+		size_t kk, nn, after;
+		bool   nl;
+		size_t pos = parse_marker( line, &id, &kk, &nn, &nl, &after );
+		if (pos == std::string::npos) {
+			std::cout << line << '\n';
+			continue;
+		}
+		Pending &pp = pending[id];
+		if (pp.received && (pp.parts.size() != nn || pp.have[kk-1]))
+			print( pp );						// id reused before the previous message completed
+		if (pp.parts.size() != nn || pp.have[kk-1]) {
+			pp = Pending();
+			pp.parts.resize( nn );
+			pp.new_line.resize( nn );
+			pp.have.resize( nn );
+		}
+		pp.parts[kk-1]    = line.substr( after );
+		pp.new_line[kk-1] = nl;
+		pp.have[kk-1]     = true;
+		if (kk == 1)
+			pp.columns = line.substr( 0, pos );
+		if (++pp.received == nn) {
+			print( pp );
+			pending.erase( id );
+		}
+	}
+	for (auto &pp : pending)
+		print( pp.second );
+	return (0);
+}   // main
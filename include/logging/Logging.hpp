@@ -15,6 +15,11 @@
 #include "TRACE/trace.h"
 
 #include "logging/internal/macro.hpp"
+#include "logging/detail/Snapshot.hxx"
+#include "logging/detail/StackCapture.hxx"
+#include "logging/detail/LogContext.hxx"
+#include "logging/detail/Recorder.hxx"
+#include "logging/detail/Continuation.hxx"
 
 namespace dunedaq::logging {
 /**
@@ -65,6 +70,19 @@ public:
 				setenv(envvar.c_str(),newval.c_str(),1);
 			}
 		}
+		// e.g. DUNEDAQ_ERS_ESCALATE="10,20,MS,60": after an error or warning, enable TLOG_DEBUG
+		// levels 0-20 (memory and slow path) of the issue's TRACE name for 10 seconds,
+		// at most once per 60 seconds per name (see logging/detail/Escalation.hxx)
+		char *escp = getenv("DUNEDAQ_ERS_ESCALATE");
+		if (escp && *escp) {
+			for (const char *envvar : {"DUNEDAQ_ERS_ERROR","DUNEDAQ_ERS_WARNING"}) {
+				std::string val(getenv(envvar));
+				if (val.find("escalate(") == std::string::npos) {
+					val.insert( strlen("erstrace"), ",escalate(" + std::string(escp) + ")" );
+					setenv(envvar,val.c_str(),1);
+				}
+			}
+		}
 
 		//setenv("DUNEDAQ_APPLICATION_NAME","XYZZY",0);
 		// std::ostringstream out;
@@ -82,6 +100,21 @@ public:
 		ers::debug(msg,lvl); // still comes out as level 0 ???
 		ers::Configuration::instance().debug_level(63);
 		char *cp;
+		// e.g. DUNEDAQ_LOGGING_RECORD=/tmp/logging_workload_%p.rec (see logging/detail/Recorder.hxx)
+		if ((cp=getenv("DUNEDAQ_LOGGING_RECORD")) && *cp) {
+			if (!Recorder::instance().start(cp))
+				ers::warning( ers::InternalMessage(lc,"cannot record the logging workload to DUNEDAQ_LOGGING_RECORD=\""+std::string(cp)+"\"") );
+		}
+		// e.g. DUNEDAQ_LOGGING_CONTEXT_RULES="link=7:5,run=1234:0-10" (see logging/detail/LogContext.hxx)
+		if ((cp=getenv("DUNEDAQ_LOGGING_CONTEXT_RULES")) && *cp) {
+			if (!ContextRules::instance().configure(cp))
+				ers::warning( ers::InternalMessage(lc,"DUNEDAQ_LOGGING_CONTEXT_RULES=\""+std::string(cp)+"\" has item(s) not of the form key=value:lvl[-lvl]") );
+		}
+		// e.g. DUNEDAQ_ERS_STACK="warning=raw,error=raw,debug=full" (see logging/detail/StackCapture.hxx)
+		if ((cp=getenv("DUNEDAQ_ERS_STACK")) && *cp) {
+			if (!StackPolicy::configure(cp))
+				ers::warning( ers::InternalMessage(lc,"DUNEDAQ_ERS_STACK=\""+std::string(cp)+"\" has item(s) not of the form severity=off|raw|full (full: debug and log only)") );
+		}
 		if ((cp=getenv("DUNEDAQ_ERS_DEBUG_LEVEL")) && *cp) {
 			int lvl=strtoul(cp,nullptr,0)+TLVL_DEBUG;
 			if (lvl>63) lvl=63;
@@ -96,6 +129,11 @@ public:
 } // namespace logging
 
 #include "logging/detail/Logger.hxx"
+#include "logging/detail/Format.hxx"
+#include "logging/detail/Escalation.hxx"
+#include "logging/detail/DebugBatch.hxx"
+#include "logging/detail/ReusableIssue.hxx"
+#include "logging/detail/JsonStream.hxx"
 
 //  The following uses gnu extension of "##" connecting "," with empty __VA_ARGS__
 //  which eats "," when __VA_ARGS__ is empty.
@@ -107,12 +145,21 @@ public:
 #               pragma GCC system_header
 #       endif
 
+// The slow path of TLOG_DEBUG is also forced when the thread's logging context
+// matches a rule for the level (see logging/detail/LogContext.hxx).
+#undef  TLOG_DEBUG
 #if TRACE_REVNUM <= 1443
-# undef  TLOG_DEBUG
 # define TLOG_DEBUG(lvl,...) TRACE_STREAMER(((TLVL_DEBUG+lvl)<64)?TLVL_DEBUG+lvl:63, \
 										  tlog_ARG2(not_used, ##__VA_ARGS__,0,need_at_least_one), \
 										  tlog_ARG3(not_used, ##__VA_ARGS__,0,"",need_at_least_one), \
-										  1, 0 )
+										  1, dunedaq::logging::context_forces(((TLVL_DEBUG+lvl)<64)?TLVL_DEBUG+lvl:63) ) \
+								<< dunedaq::logging::ContextStamp()
+#else
+// (lvl+0) allows TLOG_DEBUG()
+# define TLOG_DEBUG_LVL_(lvl) (((lvl+0)<0)?TLVL_DEBUG:((TLVL_DEBUG+(lvl+0))<64)?TLVL_DEBUG+(lvl+0):63)
+# define TLOG_DEBUG(lvl,...) TRACE_STREAMER(TLOG_DEBUG_LVL_(lvl), TLOG2(__VA_ARGS__), \
+										  dunedaq::logging::context_forces(TLOG_DEBUG_LVL_(lvl)) ) \
+								<< dunedaq::logging::ContextStamp()
 #endif
 
 #endif // LOGGING_INCLUDE_LOGGING_LOGGING_HPP_
@@ -0,0 +1,116 @@
+/**
+ * @file Continuation.hxx split long messages into linked TRACE memory records
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_CONTINUATION_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_CONTINUATION_HXX_
+
+#include <unistd.h>				// getpid
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*  A message which does not fit in a TRACE memory entry is written as n records
+    each starting with a "~<id>:<k>/<n>~" prefix (k=1..n, id in hex).  A "+"
+    before the closing "~" ("~<id>:<k>/<n>+~") means the chunk starts a new
+    line of the original message (the newline itself is not stored);
+    otherwise the chunk continues the text of chunk k-1.  Chunks are split at
+    newlines when possible, so each "caused by:" line of a cause chain starts
+    a record.  tshow | tshow_join reassembles the messages.
+ */
+namespace dunedaq::logging {
+
+struct Chunk
+{
+	size_t beg;
+	size_t len;
+	bool   new_line;			// preceded by a (dropped) newline
+};
+
+/// The message size of the TRACE memory entries.  After TRACE_INIT_CHECK this is
+/// the size of the buffer actually in use (which may have been created by another
+/// process); before, TRACE_MSGMAX from the environment, else the TRACE default.
+inline size_t trace_msgmax()
+{
+	if (traceControl_p && traceControl_p->siz_msg)
+		return traceControl_p->siz_msg;
+	static const size_t s_msgmax = []() -> size_t {
+		const char *cp = getenv( "TRACE_MSGMAX" );
+		size_t vv = (cp && *cp) ? strtoul(cp,nullptr,0) : 0;
+		if (vv)
+			return vv;
+#ifdef TRACE_DFLT_MSGMAX
+		return TRACE_DFLT_MSGMAX;
+#else
+		return 128;
+#endif
+	}();
+	return s_msgmax;
+}
+
+/// the payload of a chunk for entries of msgmax bytes (incl. terminator), given
+/// the id and (an upper bound of) the number of chunks
+inline size_t chunk_payload( size_t msgmax, uint32_t id, size_t nchunks )
+{
+	char pfx[64];
+	int  plen = snprintf( pfx, sizeof(pfx), "~%x:%zu/%zu+~", id, nchunks, nchunks );
+	return (msgmax > static_cast<size_t>(plen)+1+16) ? msgmax-1-plen : 16;
+}
+
+/// returns the number of chunks; fills chunks when not null
+inline size_t split_chunks( const char *msg, size_t len, size_t payload, std::vector<Chunk> *chunks )
+{
+	size_t nn=0, pos=0;
+	bool   new_line=false;
+	while (pos < len) {
+		size_t end = (len-pos > payload) ? pos+payload : len;
+		const void *nl = memchr( msg+pos, '\n', end-pos );
+		if (nl)
+			end = static_cast<size_t>(static_cast<const char*>(nl)-msg);
+		if (chunks)
+			chunks->push_back( Chunk{ pos, end-pos, new_line } );
+		++nn;
+		new_line = (nl != nullptr);
+		pos = end + (nl ? 1 : 0);
+		if (new_line && pos == len) break;	// a trailing newline is dropped
+	}
+	return nn;
+}
+
+/// trace() which writes messages longer than trace_msgmax() as continuation records
+/// (called after TRACE_INIT_CHECK, so the entry size of the buffer in use applies)
+inline void trace_chunked( struct timeval *tvp, int traceID, uint8_t lvl, int line, const char *function,
+                           const std::string &msg )
+{
+	size_t msgmax = trace_msgmax();
+	if (msg.size() < msgmax) {
+		trace( tvp, traceID, lvl, line, function, 0 TRACE_XTRA_PASSED, msg.c_str() );
+		return;
+	}
+	// pid in the id so that the records of processes sharing a buffer do not mix
+	static std::atomic<uint32_t> s_count{0};
+	uint32_t id = (static_cast<uint32_t>(getpid()) << 16) | (s_count.fetch_add(1,std::memory_order_relaxed) & 0xffff);
+	size_t nmax = split_chunks( msg.data(), msg.size(), chunk_payload(msgmax,id,msg.size()), nullptr );
+	std::vector<Chunk> chunks;
+	split_chunks( msg.data(), msg.size(), chunk_payload(msgmax,id,nmax), &chunks );
+	std::string rec;
+	rec.reserve( msgmax );
+	char pfx[64];
+	for (size_t kk=0; kk<chunks.size(); ++kk) {
+		snprintf( pfx, sizeof(pfx), "~%x:%zu/%zu%s~", id, kk+1, chunks.size(), chunks[kk].new_line?"+":"" );
+		rec.assign( pfx );
+		rec.append( msg, chunks[kk].beg, chunks[kk].len );
+		trace( tvp, traceID, lvl, line, function, 0 TRACE_XTRA_PASSED, rec.c_str() );
+	}
+}
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_CONTINUATION_HXX_
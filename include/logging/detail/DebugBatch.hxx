@@ -0,0 +1,189 @@
+/**
+ * @file DebugBatch.hxx emit many TLOG_DEBUG records with one level check
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_DEBUGBATCH_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_DEBUGBATCH_HXX_
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*  Example:
+        auto batch = TLOG_DEBUG_BATCH(12);
+        if (batch.enabled())
+            for (size_t ch=0; ch<nch; ++ch)
+                batch.add() << "chan " << ch << " adc " << adc[ch];
+        // records are written when batch goes out of scope (or batch.flush())
+ */
+#define TLOG_DEBUG_BATCH(lvl) dunedaq::logging::DebugBatch( (lvl+0), TRACE_NAME, __FILE__, __LINE__, __func__ )
+
+namespace dunedaq::logging {
+
+/**
+ * @brief Collects TLOG_DEBUG(lvl) style records.  The level masks are checked
+ * and the TRACE ID resolved once, at construction; the records share one time
+ * stamp.  Each record becomes its own TRACE memory entry; the slow path gets
+ * all records of a flush as one ers::debug message (one line per record).
+ */
+class DebugBatch
+{
+public:
+	class Record
+	{
+	public:
+		explicit Record( DebugBatch *bb ) : m_batch(bb) {}
+		Record( Record && oo ) noexcept : m_batch(oo.m_batch) { oo.m_batch = nullptr; }
+		Record( const Record & ) = delete;
+		~Record() { if (m_batch) m_batch->end_record(); }
+
+		Record & operator<<( const char *ss )        { if (m_batch) m_batch->m_buf += ss; return *this; }
+		Record & operator<<( const std::string &ss ) { if (m_batch) m_batch->m_buf += ss; return *this; }
+		Record & operator<<( char cc )               { if (m_batch) m_batch->m_buf += cc; return *this; }
+		// numbers are formatted with to_chars, not by a stream -- use hex(), flt() etc. (Format.hxx)
+		Record & operator<<( std::ios_base &(*)(std::ios_base &) ) = delete;
+		Record & operator<<( std::ostream &(*)(std::ostream &) ) = delete;
+		template <class T>
+		Record & operator<<( const T &vv )
+		{
+			if (!m_batch) return *this;
+			if constexpr (std::is_arithmetic_v<T> || std::is_same_v<T,IntArg> || std::is_same_v<T,HexArg>
+			              || std::is_same_v<T,FloatArg> || std::is_same_v<T,DurArg>) {
+				char buf[detail::k_fmt_bufsz];
+				m_batch->m_buf.append( buf, detail::to_chars(buf, buf+sizeof(buf), vv) );
+			} else
+				m_batch->stream() << vv;		// appends to m_buf
+			return *this;
+		}
+	private:
+		DebugBatch *m_batch;
+	};
+
+	DebugBatch( int dbglvl, const char *name, const char *file, int line, const char *function )
+		: m_line(line), m_file(file), m_function(function)
+	{
+		int lvl = TLVL_DEBUG + ((dbglvl<0) ? 0 : dbglvl);
+		m_lvl = static_cast<uint8_t>((lvl<64) ? lvl : 63);
+		struct { char tn[TRACE_TN_BUFSZ]; } _trc_;
+		if (TRACE_INIT_CHECK(trace_name(name,file,_trc_.tn,sizeof(_trc_.tn)))) {
+			m_tid  = trace_name2TID( trace_name(name,file,_trc_.tn,sizeof(_trc_.tn)) );
+			m_do_m = traceControl_rwp->mode.bits.M && (traceLvls_p[m_tid].M & TLVLMSK(m_lvl));
+			m_do_s = (traceControl_rwp->mode.bits.S && (traceLvls_p[m_tid].S & TLVLMSK(m_lvl)))
+			         || context_forces(m_lvl);
+		}
+	}
+	DebugBatch( const DebugBatch & ) = delete;
+	DebugBatch & operator=( const DebugBatch & ) = delete;
+	~DebugBatch() { flush(); }
+
+	bool   enabled() const { return m_do_m || m_do_s; }
+	size_t size()    const { return m_ends.size(); }
+
+	/// start a record; it ends when the returned Record is destroyed
+	Record add()
+	{
+		if (!enabled())
+			return Record( nullptr );
+		if (m_ends.empty()) {	// stamp the batch (since the last flush) like TLOG_DEBUG
+			m_stamp.clear();
+			if (t_context.depth) {
+				char cbuf[ThreadContext::k_stamp_max];
+				context_format( cbuf, sizeof(cbuf) );
+				m_stamp = "[" + std::string(cbuf) + "] ";
+			}
+		}
+		m_buf += m_stamp;
+		return Record( this );
+	}
+
+	/// one record per element: fn(Record&&, element)
+	template <class It, class Fn>
+	void add_range( It beg, It end, Fn fn )
+	{
+		if (!enabled())
+			return;
+		for (; beg!=end; ++beg)
+			fn( add(), *beg );
+	}
+
+	void flush()
+	{
+		if (m_ends.empty())
+			return;
+		struct timeval lclTime;
+		gettimeofday( &lclTime, nullptr );
+		size_t beg=0;
+		if (m_do_m)
+			for (size_t end : m_ends) {
+				trace( &lclTime, m_tid, m_lvl, m_line, m_function, 0 TRACE_XTRA_PASSED, &m_buf[beg] );
+				beg = end+1;
+			}
+		if (m_do_s) {
+			for (size_t ii=0; ii+1<m_ends.size(); ++ii)		// join the records: one line each
+				m_buf[m_ends[ii]] = '\n';
+			// like TLOG_DEBUG: recorded, with the stack and context qualifiers
+			detail::report_slow_path( m_tid, m_lvl, m_file, m_line, m_function, m_buf.c_str() );
+		}
+		m_buf.clear();
+		m_ends.clear();
+	}
+
+private:
+	// a streambuf appending to m_buf, so other types need no temporary string
+	class AppendBuf : public std::streambuf
+	{
+	public:
+		explicit AppendBuf( std::string &out ) : m_out(out) {}
+	protected:
+		int_type overflow( int_type cc ) override
+		{
+			if (!traits_type::eq_int_type(cc,traits_type::eof()))
+				m_out += traits_type::to_char_type( cc );
+			return traits_type::not_eof( cc );
+		}
+		std::streamsize xsputn( const char *ss, std::streamsize nn ) override { m_out.append( ss, nn ); return nn; }
+	private:
+		std::string &m_out;
+	};
+
+	std::ostream & stream()		// created on first use, then reused for the batch
+	{
+		if (!m_stream)
+			m_stream = std::make_unique<Stream>( m_buf );
+		return m_stream->os;
+	}
+	struct Stream
+	{
+		explicit Stream( std::string &out ) : buf(out), os(&buf) {}
+		AppendBuf    buf;
+		std::ostream os;
+	};
+
+	void end_record()
+	{
+		m_ends.push_back( m_buf.size() );
+		m_buf += '\0';
+	}
+
+	uint8_t             m_lvl;
+	int                 m_tid  = 0;
+	bool                m_do_m = false;
+	bool                m_do_s = false;
+	int                 m_line;
+	const char         *m_file;
+	const char         *m_function;
+	std::string         m_buf;		// the records, '\0' terminated
+	std::vector<size_t> m_ends;		// offset of each terminator
+	std::string         m_stamp;
+	std::unique_ptr<Stream> m_stream;
+};
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_DEBUGBATCH_HXX_
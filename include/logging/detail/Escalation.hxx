@@ -0,0 +1,232 @@
+/**
+ * @file Escalation.hxx temporary TRACE level escalation after errors/warnings
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_ESCALATION_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_ESCALATION_HXX_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ers/OutputStream.hpp>
+
+namespace dunedaq::logging {
+
+/**
+ * @brief Raises the memory (M) and/or slow (S) level masks of a TRACE name for
+ * a limited time and restores them afterwards.  Only the bits which were not
+ * already set are added (and later removed), so changes made in the mean time
+ * (e.g. with tonM/toffS) to other bits are left alone.  Every change is
+ * recorded in history() and as a TRACE memory entry of the affected name.
+ */
+class Escalator
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	struct Change
+	{
+		std::chrono::system_clock::time_point when;
+		std::string name;
+		uint64_t    added_M;
+		uint64_t    added_S;
+		bool        restore;			// false: raised, true: restored
+	};
+
+	static Escalator& instance() { static Escalator s_esc; return s_esc; }
+
+	/// Returns false when rate limited (min_interval since the previous escalation
+	/// of this name) or when max_active names are already escalated.
+	bool escalate( int traceID, uint64_t mskM, uint64_t mskS,
+	               std::chrono::seconds duration, std::chrono::seconds min_interval )
+	{
+		std::unique_lock<std::mutex> lk( m_mutex );
+		clock::time_point now = clock::now();
+		auto it = m_active.find( traceID );
+		if (it != m_active.end()) {
+			if (now - it->second.last < min_interval) { ++m_suppressed; return false; }
+		} else {
+			auto lt = m_last.find( traceID );
+			if (   (lt != m_last.end() && now - lt->second < min_interval)
+			    || m_active.size() >= k_max_active) { ++m_suppressed; return false; }
+			it = m_active.emplace( traceID, Active{} ).first;
+		}
+		Active &act = it->second;
+		uint64_t addM = mskM & ~__atomic_fetch_or( &traceLvls_p[traceID].M, mskM, __ATOMIC_RELAXED );
+		uint64_t addS = mskS & ~__atomic_fetch_or( &traceLvls_p[traceID].S, mskS, __ATOMIC_RELAXED );
+		act.added_M |= addM;
+		act.added_S |= addS;
+		act.last     = now;
+		act.expiry   = now + duration;
+		m_last[traceID] = now;
+		record( traceID, addM, addS, false );
+		if (!m_thread.joinable())
+			m_thread = std::thread( &Escalator::expire_loop, this );
+		m_cv.notify_one();
+		return true;
+	}
+
+	std::vector<Change> history() const
+	{
+		std::lock_guard<std::mutex> lk( m_mutex );
+		return std::vector<Change>( m_history.begin(), m_history.end() );
+	}
+	uint64_t suppressed() const { std::lock_guard<std::mutex> lk( m_mutex ); return m_suppressed; }
+
+	~Escalator()
+	{
+		{
+			std::lock_guard<std::mutex> lk( m_mutex );
+			m_stop = true;
+		}
+		m_cv.notify_one();
+		if (m_thread.joinable())
+			m_thread.join();
+	}
+
+private:
+	static const size_t k_max_active  = 16;
+	static const size_t k_max_history = 256;
+
+	struct Active
+	{
+		uint64_t          added_M = 0;
+		uint64_t          added_S = 0;
+		clock::time_point last;
+		clock::time_point expiry;
+	};
+
+	Escalator() = default;
+
+	void restore( int traceID, const Active &act )	// with m_mutex held
+	{
+		__atomic_fetch_and( &traceLvls_p[traceID].M, ~act.added_M, __ATOMIC_RELAXED );
+		__atomic_fetch_and( &traceLvls_p[traceID].S, ~act.added_S, __ATOMIC_RELAXED );
+		record( traceID, act.added_M, act.added_S, true );
+	}
+
+	void expire_loop()
+	{
+		std::unique_lock<std::mutex> lk( m_mutex );
+		while (!m_stop) {
+			clock::time_point next = clock::time_point::max();
+			clock::time_point now  = clock::now();
+			for (auto it=m_active.begin(); it!=m_active.end(); ) {
+				if (it->second.expiry <= now) {
+					restore( it->first, it->second );
+					it = m_active.erase( it );
+				} else {
+					if (it->second.expiry < next) next = it->second.expiry;
+					++it;
+				}
+			}
+			if (next == clock::time_point::max()) m_cv.wait( lk );
+			else                                  m_cv.wait_until( lk, next );
+		}
+		for (auto &aa : m_active)			// do not leave levels raised
+			restore( aa.first, aa.second );
+		m_active.clear();
+	}
+
+	void record( int traceID, uint64_t addM, uint64_t addS, bool restored )	// with m_mutex held
+	{
+		const char *name = reinterpret_cast<const char*>(idx2namsPtr(traceID));
+		if (m_history.size() >= k_max_history)
+			m_history.pop_front();
+		m_history.push_back( Change{ std::chrono::system_clock::now(), name, addM, addS, restored } );
+		if (traceControl_rwp->mode.bits.M && (traceLvls_p[traceID].M & TLVLMSK(TLVL_INFO))) {
+			char msg[200];
+			snprintf( msg, sizeof(msg), "escalation %s lvlsM 0x%llx lvlsS 0x%llx", restored?"restored":"raised",
+			          static_cast<unsigned long long>(addM), static_cast<unsigned long long>(addS) );
+			struct timeval lclTime;
+			gettimeofday( &lclTime, nullptr );
+			trace( &lclTime, traceID, TLVL_INFO, __LINE__, __func__, 0 TRACE_XTRA_PASSED, msg );
+		}
+	}
+
+	mutable std::mutex          m_mutex;
+	std::condition_variable     m_cv;
+	std::thread                 m_thread;
+	bool                        m_stop = false;
+	std::map<int,Active>        m_active;
+	std::map<int,clock::time_point> m_last;
+	std::deque<Change>          m_history;
+	uint64_t                    m_suppressed = 0;
+};
+
+} // namespace dunedaq::logging
+
+
+// The following allows "escalate(seconds,debug_lvl,M|S|MS,min_interval[,class_prefix|...])"
+// to be included in the ERS configuration, e.g. in DUNEDAQ_ERS_ERROR.
+// For each (matching) issue, TLOG_DEBUG levels 0..debug_lvl of the TRACE name of
+// the issue's file are enabled for the given seconds (see Logging::setup()).
+namespace ers
+{
+struct escalateStream : public OutputStream {
+	explicit escalateStream( const std::string & params )
+	{
+		std::vector<std::string> pp;
+		size_t beg=0;
+		for (size_t end; (end=params.find(',',beg)) != std::string::npos; beg=end+1)
+			pp.push_back( params.substr(beg,end-beg) );
+		pp.push_back( params.substr(beg) );
+		if (pp.size() > 0 && !pp[0].empty()) m_duration     = std::chrono::seconds( strtoul(pp[0].c_str(),nullptr,0) );
+		int lvl = (pp.size() > 1 && !pp[1].empty()) ? static_cast<int>(strtoul(pp[1].c_str(),nullptr,0)) : 55;
+		if (lvl > 63-TLVL_DEBUG) lvl = 63-TLVL_DEBUG;
+		uint64_t dbgmsk = ((lvl+TLVL_DEBUG == 63) ? ~0ULL : ((1ULL<<(lvl+TLVL_DEBUG+1))-1)) & ~((1ULL<<TLVL_DEBUG)-1);
+		std::string where = (pp.size() > 2 && !pp[2].empty()) ? pp[2] : "M";
+		if (where.find_first_of("Mm") != std::string::npos) m_mskM = dbgmsk;
+		if (where.find_first_of("Ss") != std::string::npos) m_mskS = dbgmsk;
+		if (pp.size() > 3 && !pp[3].empty()) m_min_interval = std::chrono::seconds( strtoul(pp[3].c_str(),nullptr,0) );
+		if (pp.size() > 4) {
+			beg=0;
+			for (size_t end; (end=pp[4].find('|',beg)) != std::string::npos; beg=end+1)
+				m_classes.push_back( pp[4].substr(beg,end-beg) );
+			m_classes.push_back( pp[4].substr(beg) );
+		}
+	}
+
+	void write( const ers::Issue & issue )
+	{
+		if (matches(issue)) {
+			struct { char tn[TRACE_TN_BUFSZ]; } _trc_;
+			if (TRACE_INIT_CHECK(trace_name(TRACE_NAME,issue.context().file_name(),_trc_.tn,sizeof(_trc_.tn)))) {
+				int traceID = trace_name2TID( trace_name(TRACE_NAME,issue.context().file_name(),_trc_.tn,sizeof(_trc_.tn)) );
+				dunedaq::logging::Escalator::instance().escalate( traceID, m_mskM, m_mskS, m_duration, m_min_interval );
+			}
+		}
+		chained().write( issue );
+	}
+
+private:
+	bool matches( const ers::Issue & issue ) const
+	{
+		if (m_classes.empty())
+			return true;
+		const char *cls = issue.get_class_name();
+		for (const std::string &pfx : m_classes)
+			if (strncmp(cls,pfx.c_str(),pfx.size()) == 0)
+				return true;
+		return false;
+	}
+
+	std::chrono::seconds     m_duration{10};
+	std::chrono::seconds     m_min_interval{60};
+	uint64_t                 m_mskM = 0;
+	uint64_t                 m_mskS = 0;
+	std::vector<std::string> m_classes;
+};
+}
+LOGGING_REGISTER_OUTPUT_STREAM( ers::escalateStream, "escalate", param, escalate )
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_ESCALATION_HXX_
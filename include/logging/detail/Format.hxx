@@ -0,0 +1,192 @@
+/**
+ * @file Format.hxx std::to_chars based TraceStreamer inserters
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_FORMAT_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_FORMAT_HXX_
+
+#include <charconv>				// std::to_chars
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/*  The wrappers below format directly into the TraceStreamer message (via
+    msg_append) without going through std::ostream, e.g.:
+        using namespace dunedaq::logging;
+        TLOG_DEBUG(lvl) << "tidx " << dec(thread_idx) << " addr " << hex(ptr, 8)
+                        << " took " << dur(t1-t0) << " adcs " << span(adcs, 16);
+ */
+namespace dunedaq::logging {
+
+struct IntArg   { uint64_t value; bool negative; };
+struct HexArg   { uint64_t value; int width; };
+struct FloatArg { double value; int precision; };
+struct DurArg   { double ns; };
+template <class T>
+struct SpanArg  { const T *data; size_t size; size_t max; };
+
+template <class T, std::enable_if_t<std::is_integral_v<T>,int> = 0>
+inline IntArg dec( T vv )
+{
+	if constexpr (std::is_signed_v<T>) {
+		if (vv < 0)
+			return IntArg{ static_cast<uint64_t>(0) - static_cast<uint64_t>(vv), true };
+	}
+	return IntArg{ static_cast<uint64_t>(vv), false };
+}
+
+/// "0x" followed by at least width (zero padded) hex digits
+template <class T, std::enable_if_t<std::is_integral_v<T>,int> = 0>
+inline HexArg hex( T vv, int width=0 )
+{
+	return HexArg{ static_cast<uint64_t>(static_cast<std::make_unsigned_t<T>>(vv)), width };
+}
+inline HexArg hex( const void *ptr, int width=0 ) { return HexArg{ reinterpret_cast<uintptr_t>(ptr), width }; }
+
+/// precision < 0 gives the shortest representation which round trips
+inline FloatArg flt( double vv, int precision=-1 ) { return FloatArg{ vv, precision }; }
+
+/// printed with the unit (ns, us, ms or s) which suits the magnitude
+template <class Rep, class Period>
+inline DurArg dur( std::chrono::duration<Rep,Period> dd )
+{
+	return DurArg{ std::chrono::duration<double,std::nano>(dd).count() };
+}
+
+/// at most max elements are printed, followed by the count of the omitted ones
+template <class T>
+inline SpanArg<T> span( const T *data, size_t size, size_t max=32 )
+{
+	static_assert( std::is_arithmetic_v<T>, "span() only supports arithmetic element types" );
+	return SpanArg<T>{ data, size, max };
+}
+template <class T, class A>
+inline SpanArg<T> span( const std::vector<T,A> &vec, size_t max=32 ) { return span( vec.data(), vec.size(), max ); }
+
+namespace detail {
+
+// worst case: 64 bit value in base 2 plus sign, or a double in fixed notation with a large exponent
+static constexpr size_t k_fmt_bufsz = 0x180;
+
+inline char *to_chars( char *pp, char *end, const IntArg &aa )
+{
+	if (aa.negative && pp < end)
+		*pp++ = '-';
+	return std::to_chars( pp, end, aa.value ).ptr;
+}
+
+inline char *to_chars( char *pp, char *end, const HexArg &aa )
+{
+	char digits[16];
+	char *dend = std::to_chars( digits, digits+sizeof(digits), aa.value, 16 ).ptr;
+	int   ndig = static_cast<int>(dend - digits);
+	*pp++ = '0'; *pp++ = 'x';
+	for (int ii=ndig; ii<aa.width && pp<end; ++ii)
+		*pp++ = '0';
+	for (char *dp=digits; dp<dend && pp<end; )
+		*pp++ = *dp++;
+	return pp;
+}
+
+inline char *to_chars( char *pp, char *end, const FloatArg &aa )
+{
+	std::to_chars_result rr = (aa.precision < 0)
+		? std::to_chars( pp, end, aa.value )
+		: std::to_chars( pp, end, aa.value, std::chars_format::fixed, aa.precision );
+	return (rr.ec == std::errc()) ? rr.ptr : pp;
+}
+
+inline char *to_chars( char *pp, char *end, const DurArg &aa )
+{
+	double      vv   = aa.ns;
+	const char *unit = "ns";
+	double      mag  = vv < 0 ? -vv : vv;
+	if      (mag >= 1e9) { vv /= 1e9; unit = "s";  }
+	else if (mag >= 1e6) { vv /= 1e6; unit = "ms"; }
+	else if (mag >= 1e3) { vv /= 1e3; unit = "us"; }
+	std::to_chars_result rr = (unit[0] == 'n')
+		? std::to_chars( pp, end, static_cast<int64_t>(vv) )
+		: std::to_chars( pp, end, vv, std::chars_format::fixed, 3 );
+	if (rr.ec != std::errc())
+		return pp;
+	pp = rr.ptr;
+	while (*unit && pp < end)
+		*pp++ = *unit++;
+	return pp;
+}
+
+template <class T>
+inline char *to_chars( char *pp, char *end, const T &vv )
+{
+	if constexpr (std::is_same_v<T,bool>)
+		return to_chars( pp, end, IntArg{ vv, false } );
+	else if constexpr (std::is_integral_v<T>)
+		return to_chars( pp, end, dec(vv) );
+	else
+		return to_chars( pp, end, FloatArg{ static_cast<double>(vv), -1 } );
+}
+
+inline void append( TraceStreamer& x, char *buf, char *end )
+{
+	*end = '\0';
+	x.msg_append( buf );
+}
+
+} // namespace detail
+} // namespace dunedaq::logging
+
+
+// The following fit the operator<<(TraceStreamer&, ...) overloads in Logger.hxx
+template <class ArgT>
+inline TraceStreamer& tlog_fmt_scalar( TraceStreamer& x, const ArgT &aa )
+{
+	if (x.do_m || x.do_s) {
+		char buf[dunedaq::logging::detail::k_fmt_bufsz];
+		dunedaq::logging::detail::append( x, buf, dunedaq::logging::detail::to_chars(buf, buf+sizeof(buf)-1, aa) );
+	}
+	return x;
+}
+
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::IntArg &aa)   { return tlog_fmt_scalar( x, aa ); }
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::HexArg &aa)   { return tlog_fmt_scalar( x, aa ); }
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::FloatArg &aa) { return tlog_fmt_scalar( x, aa ); }
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::DurArg &aa)   { return tlog_fmt_scalar( x, aa ); }
+
+template <class T>
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::SpanArg<T> &aa)
+{
+	if (x.do_m || x.do_s) {
+		namespace ld = dunedaq::logging::detail;
+		char  buf[ld::k_fmt_bufsz];
+		char *end = buf+sizeof(buf)-1;  // room for the terminator
+		char *pp  = buf;
+		size_t nn = (aa.size < aa.max) ? aa.size : aa.max;
+		*pp++ = '{';
+		for (size_t ii=0; ii<nn; ++ii) {
+			if (end-pp < 64) {		// flush before an element could be cut
+				ld::append( x, buf, pp );
+				pp = buf;
+			}
+			if (ii) { *pp++ = ','; *pp++ = ' '; }
+			pp = ld::to_chars( pp, end, aa.data[ii] );
+		}
+		if (nn < aa.size) {
+			if (end-pp < 64) {
+				ld::append( x, buf, pp );
+				pp = buf;
+			}
+			const char *more = nn ? ", ... +" : "... +";
+			while (*more) *pp++ = *more++;
+			pp = ld::to_chars( pp, end, dunedaq::logging::dec(aa.size-nn) );
+		}
+		*pp++ = '}';
+		ld::append( x, buf, pp );
+	}
+	return x;
+}
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_FORMAT_HXX_
@@ -0,0 +1,348 @@
+/**
+ * @file JsonStream.hxx JSON-lines ERS output stream
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_JSONSTREAM_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_JSONSTREAM_HXX_
+
+#include <time.h>				// gmtime_r
+#include <chrono>
+#include <cmath>				// std::isfinite
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#include <ers/OutputStream.hpp>
+
+/*  One line per issue, e.g.:
+    {"time":"2021-03-04T05:06:07.123456Z","severity":"WARNING","class":"dunedaq::readout::DataLost",
+     "message":"...","context":{"host":"...","application":"...","pid":123,"tid":456,"package":"readout",
+     "file":"...","line":42,"function":"..."},"qualifiers":["readout"],
+     "attrs":{"link":7,"count":12},"cause":{...}}
+    "attrs" holds the attributes of the issue: the issue classes declared with
+    ERS_DECLARE_ISSUE/ERS_DECLARE_ISSUE_BASE after logging/Logging.hpp get a
+    serializer generated by internal/macro.hpp which writes each attribute as
+    its declared type (number, bool or string); other classes (e.g. declared
+    in ers itself) fall back to all parameters() as strings.
+ */
+namespace dunedaq::logging::json {
+
+namespace detail {
+
+inline void append_escape( std::string &out, char cc )
+{
+	switch (cc) {
+	case '"':  out += "\\\""; break;
+	case '\\': out += "\\\\"; break;
+	case '\n': out += "\\n";  break;
+	case '\r': out += "\\r";  break;
+	case '\t': out += "\\t";  break;
+	case '\b': out += "\\b";  break;
+	case '\f': out += "\\f";  break;
+	default: {
+		static const char hex[] = "0123456789abcdef";
+		char uu[6] = { '\\', 'u', '0', '0', hex[(cc>>4)&0xf], hex[cc&0xf] };
+		out.append( uu, sizeof(uu) );
+	}
+	}
+}
+
+inline bool needs_escape( char cc )
+{
+	return static_cast<unsigned char>(cc) < 0x20 || cc == '"' || cc == '\\';
+}
+
+inline const char *find_escape_scalar( const char *pp, const char *end )
+{
+	while (pp < end && !needs_escape(*pp))
+		++pp;
+	return pp;
+}
+
+/// 8 bytes at a time; the lowest flagged byte is exact (little endian)
+inline const char *find_escape_swar( const char *pp, const char *end )
+{
+	const uint64_t ones = 0x0101010101010101ULL, highs = 0x8080808080808080ULL;
+	for (; end-pp >= 8; pp += 8) {
+		uint64_t ww;
+		memcpy( &ww, pp, sizeof(ww) );
+		uint64_t qq = ww ^ (ones*'"'), bb = ww ^ (ones*'\\');
+		uint64_t tt = (((qq-ones) & ~qq) | ((bb-ones) & ~bb) | ((ww-ones*0x20) & ~ww)) & highs;
+		if (tt)
+			return pp + (__builtin_ctzll(tt) >> 3);
+	}
+	return find_escape_scalar( pp, end );
+}
+
+#if defined(__SSE2__)
+inline const char *find_escape_sse2( const char *pp, const char *end )
+{
+	const __m128i quote  = _mm_set1_epi8( '"' );
+	const __m128i bslash = _mm_set1_epi8( '\\' );
+	const __m128i ctl    = _mm_set1_epi8( 0x1f );
+	for (; end-pp >= 16; pp += 16) {
+		__m128i vv = _mm_loadu_si128( reinterpret_cast<const __m128i*>(pp) );
+		__m128i mm = _mm_or_si128( _mm_or_si128(_mm_cmpeq_epi8(vv,quote), _mm_cmpeq_epi8(vv,bslash)),
+		                           _mm_cmpeq_epi8(_mm_min_epu8(vv,ctl), vv) );	// unsigned vv <= 0x1f
+		int bits = _mm_movemask_epi8( mm );
+		if (bits)
+			return pp + __builtin_ctz(bits);
+	}
+	return find_escape_swar( pp, end );
+}
+#endif
+
+template <const char *(*Find)(const char *, const char *)>
+inline void append_escaped_with( std::string &out, const char *ss, size_t nn )
+{
+	const char *pp = ss, *end = ss+nn;
+	while (pp < end) {
+		const char *qq = Find( pp, end );
+		out.append( pp, static_cast<size_t>(qq-pp) );
+		if (qq == end)
+			break;
+		append_escape( out, *qq );
+		pp = qq+1;
+	}
+}
+
+} // namespace detail
+
+/// append the JSON string escaped text (without the quotes)
+inline void append_escaped( std::string &out, const char *ss, size_t nn )
+{
+#if defined(__SSE2__)
+	detail::append_escaped_with<detail::find_escape_sse2>( out, ss, nn );
+#else
+	detail::append_escaped_with<detail::find_escape_swar>( out, ss, nn );
+#endif
+}
+
+inline void append_string( std::string &out, std::string_view sv )
+{
+	out += '"';
+	append_escaped( out, sv.data(), sv.size() );
+	out += '"';
+}
+
+template <class T>
+inline void append_value( std::string &out, const T &vv )
+{
+	if constexpr (std::is_same_v<T,bool>) {
+		out += vv ? "true" : "false";
+	} else if constexpr (std::is_same_v<T,char>) {
+		append_string( out, std::string_view(&vv,1) );
+	} else if constexpr (std::is_arithmetic_v<T>) {
+		if constexpr (std::is_floating_point_v<T>)
+			if (!std::isfinite(vv)) { out += "null"; return; }
+		char buf[dunedaq::logging::detail::k_fmt_bufsz];
+		out.append( buf, dunedaq::logging::detail::to_chars(buf, buf+sizeof(buf), vv) );
+	} else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+		append_string( out, std::string_view(vv) );
+	} else {							// as ers formats it for parameters()
+		std::ostringstream oss;
+		oss << vv;
+		append_string( out, oss.str() );
+	}
+}
+
+/// ,"name":value
+template <class T>
+inline void append_attr( std::string &out, const char *name, const T &vv )
+{
+	if (out.back() != '{') out += ',';
+	out += '"';
+	out += name;						// attribute names are identifiers
+	out += "\":";
+	append_value( out, vv );
+}
+
+/// ,"name":value for an attribute of type T from the text ers keeps for it in
+/// parameters() -- used by the serializers generated in internal/macro.hpp.
+/// The type is known at compile time, so the text is not parsed: numbers are
+/// copied as they are, bools mapped and everything else is a JSON string.
+template <class T, class Params>
+inline void append_attr_text( std::string &out, const char *name, const Params &params )
+{
+	auto it = params.find( name );
+	if (it == params.end())
+		return;
+	const std::string &text = it->second;
+	if (out.back() != '{') out += ',';
+	out += '"';
+	out += name;
+	out += "\":";
+	if constexpr (std::is_same_v<T,bool>) {
+		out += (text == "1" || text == "true") ? "true" : "false";
+	} else if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T,char>
+	                     && !std::is_same_v<T,signed char> && !std::is_same_v<T,unsigned char>) {
+		if (text.empty() || text.find_first_of("nNiI") != std::string::npos)	// nan, inf
+			out += "null";
+		else
+			out += text;
+	} else {
+		append_string( out, text );
+	}
+}
+
+using Serializer = void (*)( std::string &, const ers::Issue & );
+
+/**
+ * @brief Issue class name (get_uid()) -> attribute serializer.  Filled during
+ * static initialization by the issue declarations; lookups do not lock.
+ */
+class SerializerRegistry
+{
+public:
+	using Map = std::unordered_map<std::string_view,Serializer>;
+
+	static SerializerRegistry& instance() { static SerializerRegistry s_reg; return s_reg; }
+
+	bool add( const char *uid, Serializer ser )
+	{
+		m_map.update( [uid,ser](Map &mm) { mm[uid] = ser; } );	// uid is a literal
+		return true;
+	}
+
+	Serializer find( const char *uid ) const
+	{
+		auto mm = m_map.read();
+		auto it = mm->find( uid );
+		return (it != mm->end()) ? it->second : nullptr;
+	}
+
+private:
+	SerializerRegistry() = default;
+	Snapshot<Map> m_map;
+};
+
+inline bool register_serializer( const char *uid, Serializer ser ) { return SerializerRegistry::instance().add( uid, ser ); }
+
+/// "YYYY-MM-DDTHH:MM:SS.uuuuuuZ"; the part up to the seconds is cached per thread
+inline void append_time( std::string &out, std::chrono::system_clock::time_point tp )
+{
+	thread_local time_t t_secs = -1;
+	thread_local char   t_buf[32];
+	int64_t us = std::chrono::duration_cast<std::chrono::microseconds>( tp.time_since_epoch() ).count();
+	time_t secs = static_cast<time_t>(us/1000000);
+	if (secs != t_secs) {
+		struct tm tm_s;
+		gmtime_r( &secs, &tm_s );
+		strftime( t_buf, sizeof(t_buf), "%Y-%m-%dT%H:%M:%S", &tm_s );
+		t_secs = secs;
+	}
+	char frac[8] = { '.', '0', '0', '0', '0', '0', '0', 'Z' };
+	for (int ii=6, uu=static_cast<int>(us%1000000); ii>0; --ii, uu/=10)
+		frac[ii] = static_cast<char>('0'+uu%10);
+	out += '"';
+	out += t_buf;
+	out.append( frac, sizeof(frac) );
+	out += '"';
+}
+
+inline void append_issue( std::string &out, const ers::Issue &issue )
+{
+	out += "{\"time\":";
+	append_time( out, issue.ptime() );
+	out += ",\"severity\":";
+	append_string( out, ers::to_string(issue.severity()) );
+	if (issue.severity().type == ers::Debug) {
+		out += ",\"level\":";
+		append_value( out, issue.severity().rank );
+	}
+	out += ",\"class\":";
+	append_string( out, issue.get_class_name() );
+	out += ",\"message\":";
+	append_string( out, issue.message() );
+
+	const ers::Context &cc = issue.context();
+	out += ",\"context\":{\"host\":";
+	append_string( out, cc.host_name() );
+	out += ",\"application\":";
+	append_string( out, cc.application_name() );
+	out += ",\"pid\":";
+	append_value( out, cc.process_id() );
+	out += ",\"tid\":";
+	append_value( out, cc.thread_id() );
+	out += ",\"package\":";
+	append_string( out, cc.package_name() );
+	out += ",\"file\":";
+	append_string( out, cc.file_name() );
+	out += ",\"line\":";
+	append_value( out, cc.line_number() );
+	out += ",\"function\":";
+	append_string( out, cc.function_name() );
+	out += '}';
+
+	if (!issue.qualifiers().empty()) {
+		out += ",\"qualifiers\":[";
+		for (size_t ii=0; ii<issue.qualifiers().size(); ++ii) {
+			if (ii) out += ',';
+			append_string( out, issue.qualifiers()[ii] );
+		}
+		out += ']';
+	}
+
+	out += ",\"attrs\":{";
+	// consecutive issues are often of the same class
+	thread_local const char *t_cls = nullptr;
+	thread_local Serializer  t_ser = nullptr;
+	const char *cls = issue.get_class_name();
+	if (cls != t_cls) {
+		t_ser = SerializerRegistry::instance().find( cls );
+		t_cls = cls;
+	}
+	if (t_ser)
+		t_ser( out, issue );
+	else
+		for (const auto &pp : issue.parameters())
+			append_attr( out, pp.first.c_str(), pp.second );
+	out += '}';
+
+	if (issue.cause()) {
+		out += ",\"cause\":";
+		append_issue( out, *issue.cause() );
+	}
+	out += '}';
+}
+
+} // namespace dunedaq::logging::json
+
+
+// The following allows "json" (stdout) or "json(stderr)" to be included in the
+// ERS configuration, e.g. DUNEDAQ_ERS_INFO="erstrace,json".
+namespace ers
+{
+struct jsonStream : public OutputStream {
+	explicit jsonStream( const std::string & param )
+		: m_fp( (param == "stderr") ? stderr : stdout ) {}
+
+	void write( const ers::Issue & issue )
+	{
+		thread_local std::string t_line;	// keeps its capacity
+		t_line.clear();
+		dunedaq::logging::json::append_issue( t_line, issue );
+		t_line += '\n';
+		fwrite( t_line.data(), 1, t_line.size(), m_fp );	// one (locked) stdio call per line
+		chained().write( issue );
+	}
+
+private:
+	FILE *m_fp;
+};
+}
+LOGGING_REGISTER_OUTPUT_STREAM( ers::jsonStream, "json", param, json )
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_JSONSTREAM_HXX_
@@ -0,0 +1,243 @@
+/**
+ * @file LogContext.hxx thread local logging context and context keyed debug enables
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_LOGCONTEXT_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_LOGCONTEXT_HXX_
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*  Example:
+        void LinkHandler::run( int link ) {
+            dunedaq::logging::ContextScope cs( "link", link );
+            TLOG_DEBUG(5) << "got frame";   // record text: "[link=7] got frame"
+        }
+    and, with DUNEDAQ_LOGGING_CONTEXT_RULES="link=7:5" (or add_context_rule("link",7,5,5)),
+    TLOG_DEBUG(5) goes to the slow path only on the thread(s) serving link 7.
+ */
+namespace dunedaq::logging {
+
+struct ContextEntry
+{
+	const char *key;			// expected to be a literal (not copied)
+	int64_t     ival;
+	char        sval[16];		// truncated copy of a string value
+	bool        is_str;
+};
+
+struct ThreadContext
+{
+	static const unsigned k_max_depth = 8;
+	static const size_t   k_stamp_max = 160;	// max length of the formatted context
+	ContextEntry entries[k_max_depth];
+	unsigned     depth;
+	uint64_t     forced;		// TRACE level bits whose slow path is forced by the rules
+};
+// trivially constructible, so access does not need a guard
+inline thread_local ThreadContext t_context{};
+
+struct ContextRule
+{
+	std::string key;
+	bool        is_str;
+	int64_t     ival;
+	std::string sval;
+	uint64_t    lvls;			// TRACE level bits (TLVL_DEBUG+n)
+};
+
+/**
+ * @brief The enable rules.  Rule changes are picked up by a thread the next
+ * time it enters or leaves a ContextScope, so they are normally set up in
+ * Logging::setup() (DUNEDAQ_LOGGING_CONTEXT_RULES) before threads start.
+ */
+class ContextRules
+{
+public:
+	using Rules = std::vector<ContextRule>;
+
+	static ContextRules& instance() { static ContextRules s_rules; return s_rules; }
+
+	Snapshot<Rules>::Reader rules() const { return m_rules.read(); }
+
+	/// changes with every add(); 0 while there are no rules
+	static uint64_t generation() { return s_generation.load( std::memory_order_acquire ); }
+
+	void add( const ContextRule &rule )
+	{
+		m_rules.update( [&rule](Rules &rr) { rr.push_back( rule ); } );
+		s_generation.fetch_add( 1, std::memory_order_release );	// after the rules are published
+	}
+
+	/// parse "key=value:lvl[-lvl][,...]" (debug levels); returns false if any item is not understood
+	bool configure( const std::string &spec )
+	{
+		bool   ok=true;
+		size_t beg=0;
+		while (beg < spec.size()) {
+			size_t end = spec.find( ',', beg );
+			if (end == std::string::npos) end = spec.size();
+			std::string item = spec.substr( beg, end-beg );
+			beg = end+1;
+			size_t eq = item.find( '=' ), co = item.rfind( ':' );
+			if (eq == std::string::npos || co == std::string::npos || co < eq) { ok=false; continue; }
+			ContextRule rule{ item.substr(0,eq), false, 0, item.substr(eq+1,co-eq-1), 0 };
+			const char *vb = rule.sval.c_str(), *ve = vb+rule.sval.size();
+			auto vr = std::from_chars( vb, ve, rule.ival );
+			rule.is_str = (vr.ec != std::errc() || vr.ptr != ve);
+			unsigned lo=0, hi=0;
+			const char *lb = item.c_str()+co+1, *le = item.c_str()+item.size();
+			auto lr = std::from_chars( lb, le, lo );
+			hi = lo;
+			if (lr.ec == std::errc() && lr.ptr < le && *lr.ptr == '-')
+				lr = std::from_chars( lr.ptr+1, le, hi );
+			if (lr.ec != std::errc() || lr.ptr != le || hi < lo) { ok=false; continue; }
+			for (unsigned ll=lo; ll<=hi && TLVL_DEBUG+ll<64; ++ll)
+				rule.lvls |= 1ULL<<(TLVL_DEBUG+ll);
+			add( rule );
+		}
+		return ok;
+	}
+
+private:
+	ContextRules() = default;
+	Snapshot<Rules> m_rules;
+	static inline std::atomic<uint64_t> s_generation{0};
+};
+
+inline void add_context_rule( const char *key, int64_t value, int dbglvl_lo, int dbglvl_hi )
+{
+	ContextRules::instance().configure( std::string(key) + "=" + std::to_string(value) + ":"
+	                                    + std::to_string(dbglvl_lo) + "-" + std::to_string(dbglvl_hi) );
+}
+
+namespace detail {
+// Called on every ContextScope enter/leave: without rules this is one load of the
+// generation; with rules, the thread matches against its own copy of them, which
+// is refreshed (from the shared snapshot) only when the generation changes.
+inline void update_forced( ThreadContext &tc )
+{
+	uint64_t gen = ContextRules::generation();
+	if (gen == 0) {
+		tc.forced = 0;
+		return;
+	}
+	struct RulesCache { uint64_t gen = 0; ContextRules::Rules rules; };
+	static thread_local RulesCache t_cache;
+	if (t_cache.gen != gen) {
+		t_cache.rules = *ContextRules::instance().rules();
+		t_cache.gen   = gen;
+	}
+	uint64_t forced = 0;
+	for (const ContextRule &rule : t_cache.rules) {
+		for (unsigned ii=tc.depth; ii-- > 0; ) {	// innermost entry with the key
+			const ContextEntry &ee = tc.entries[ii];
+			if (strcmp(ee.key,rule.key.c_str()) != 0)
+				continue;
+			if (ee.is_str ? (rule.is_str && strcmp(ee.sval,rule.sval.c_str()) == 0)
+			              : (!rule.is_str && ee.ival == rule.ival))
+				forced |= rule.lvls;
+			break;
+		}
+	}
+	tc.forced = forced;
+}
+} // namespace detail
+
+/**
+ * @brief RAII entry of the thread's logging context.  Entries beyond
+ * ThreadContext::k_max_depth (or with a null key) are ignored; a null string
+ * value is recorded as "(null)".
+ */
+class ContextScope
+{
+public:
+	// a template so that e.g. ("run",0) is not ambiguous with the const char * value
+	template <class Int, std::enable_if_t<std::is_integral_v<Int>,int> = 0>
+	ContextScope( const char *key, Int value )
+	{
+		if (push(key)) {
+			t_context.entries[t_context.depth-1].ival = static_cast<int64_t>(value);
+			detail::update_forced( t_context );
+		}
+	}
+	ContextScope( const char *key, const char *value )
+	{
+		if (push(key)) {
+			ContextEntry &ee = t_context.entries[t_context.depth-1];
+			ee.is_str = true;
+			strncpy( ee.sval, value?value:"(null)", sizeof(ee.sval)-1 );
+			ee.sval[sizeof(ee.sval)-1] = '\0';
+			detail::update_forced( t_context );
+		}
+	}
+	ContextScope( const char *key, const std::string &value ) : ContextScope( key, value.c_str() ) {}
+	~ContextScope()
+	{
+		if (m_pushed) {
+			--t_context.depth;
+			detail::update_forced( t_context );
+		}
+	}
+	ContextScope( const ContextScope & ) = delete;
+	ContextScope & operator=( const ContextScope & ) = delete;
+
+private:
+	bool push( const char *key )
+	{
+		if (key == nullptr || t_context.depth >= ThreadContext::k_max_depth)
+			return false;
+		t_context.entries[t_context.depth++] = ContextEntry{ key, 0, {}, false };
+		return m_pushed = true;
+	}
+	bool m_pushed = false;
+};
+
+/// used as the force_s argument of TRACE_STREAMER in TLOG_DEBUG
+inline int context_forces( int lvl ) { return static_cast<int>((t_context.forced >> (lvl & 63)) & 1); }
+
+/// "key=value key=value" of the thread's context; returns the length (0 when empty)
+inline size_t context_format( char *buf, size_t bufsz )
+{
+	char *pp = buf, *end = buf+bufsz-1;
+	for (unsigned ii=0; ii<t_context.depth; ++ii) {
+		const ContextEntry &ee = t_context.entries[ii];
+		size_t kl = strlen( ee.key );
+		size_t vl = ee.is_str ? strlen(ee.sval) : 20;
+		if (static_cast<size_t>(end-pp) < kl+vl+2) break;
+		if (ii) *pp++ = ' ';
+		memcpy( pp, ee.key, kl ); pp += kl;
+		*pp++ = '=';
+		if (ee.is_str) { memcpy( pp, ee.sval, vl ); pp += vl; }
+		else             pp = std::to_chars( pp, end, ee.ival ).ptr;
+	}
+	*pp = '\0';
+	return static_cast<size_t>(pp-buf);
+}
+
+struct ContextStamp {};
+
+} // namespace dunedaq::logging
+
+// Appended by TLOG()/TLOG_DEBUG(): prefixes the record with "[key=value ...] "
+inline TraceStreamer& operator<<(TraceStreamer& x, const dunedaq::logging::ContextStamp &)
+{
+	if (dunedaq::logging::t_context.depth && (x.do_m || x.do_s)) {
+		char buf[dunedaq::logging::ThreadContext::k_stamp_max+4];
+		buf[0] = '[';
+		size_t len = dunedaq::logging::context_format( buf+1, dunedaq::logging::ThreadContext::k_stamp_max );
+		buf[1+len] = ']'; buf[2+len] = ' '; buf[3+len] = '\0';
+		x.msg_append( buf );
+	}
+	return x;
+}
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_LOGCONTEXT_HXX_
@@ -11,6 +11,48 @@
 #include <stdlib.h>				// setenv
 
 
+namespace dunedaq::logging::detail {
+/*  The slow path of a formatted TLOG()/TLOG_DEBUG() (verstrace_user) or
+    TLOG_DEBUG_BATCH (DebugBatch::flush) message: workload recording, stack
+    (StackPolicy), the thread's context as qualifiers, then ers::log/ers::debug.
+ */
+__attribute__((noinline)) inline void report_slow_path( int TID, uint8_t lvl, const char *file, int line,
+                                                         const char *function, const char *outp )
+{
+	if (dunedaq::logging::Recorder::enabled())
+		dunedaq::logging::Recorder::instance().record( lvl, strlen(outp), dunedaq::logging::Recorder::k_verstrace );
+	dunedaq::logging::StackMode stack_mode = dunedaq::logging::StackPolicy::mode( (lvl<TLVL_DEBUG)?ers::Log:ers::Debug );
+	std::string sbuf;
+	if (stack_mode == dunedaq::logging::StackMode::Raw) {
+		sbuf = outp;
+		dunedaq::logging::append_stack( sbuf, stack_mode, 2 );	// not append_stack and this function
+		outp = sbuf.c_str();
+	}
+	// LocalContext args: 1-"package_name" 2-"file" 3-"line" 4-"pretty_function" 5-"include_stack"
+	ers::LocalContext lc(
+						 reinterpret_cast<char*>(idx2namsPtr(TID)),
+						 file, line, function,
+						 (DEBUG_FORCED) || stack_mode==dunedaq::logging::StackMode::Full );
+	//std::ostringstream ers_report_impl_out_buffer;
+	//ers_report_impl_out_buffer << outp;
+	ers::InternalMessage imsg(lc,outp);
+	// the thread's logging context entries become qualifiers ("key=value")
+	const dunedaq::logging::ThreadContext &tctx = dunedaq::logging::t_context;
+	for (unsigned ii=0; ii<tctx.depth; ++ii)
+		imsg.add_qualifier( std::string(tctx.entries[ii].key) + "="
+		                    + (tctx.entries[ii].is_str ? std::string(tctx.entries[ii].sval) : std::to_string(tctx.entries[ii].ival)) );
+	if (lvl < TLVL_DEBUG) { // NOTE: at least currently, TLVL_LOG is numerically 1 less than TLVL_DEBUG
+		//auto d = std::chrono::seconds{tvp->tv_sec} + std::chrono::microseconds{tvp->tv_usec};
+		////std::chrono::system_clock::time_point tp{std::chrono::duration_cast<std::chrono::system_clock::duration>(d)};
+		//std::chrono::system_clock::time_point tp{d};
+		// PROTECTED - ers::Issue iss( ers::Issue( ers::Severity(ers::Log), tp, lc, outp, std::vector<std::string>(), std::map<std::string,std::string>(), nullptr ));
+		ers::log(   imsg );
+	} else {
+		ers::debug( imsg,lvl-TLVL_DEBUG );
+	}
+}
+} // namespace dunedaq::logging::detail
+
 /*  verstrace_user
     Only log and debug "levels" (or "streams") are supported
  */
@@ -27,6 +69,7 @@ static void verstrace_user(struct timeval */*tvp*/, int TID, uint8_t lvl, const
 	int    retval;
 	const char *outp;
 	char   obuf[TRACE_USER_MSGMAX];
+	std::string dbuf;			// used instead of obuf when the message does not fit
 
 	if ((insert && (printed = strlen(insert))) || nargs)
 	{
@@ -37,42 +80,52 @@ static void verstrace_user(struct timeval */*tvp*/, int TID, uint8_t lvl, const
 			printed = TRACE_SNPRINTED(retval,sizeof(obuf));
 		}
 		if (nargs) {
+			va_list ap_copy;
+			va_copy( ap_copy, ap );
 			retval = vsnprintf(&(obuf[printed]), sizeof(obuf) - printed, msg, ap); // man page say obuf will always be terminated
-			printed += TRACE_SNPRINTED(retval,sizeof(obuf)-printed);
+			if (retval >= 0 && static_cast<size_t>(retval) >= sizeof(obuf)-printed) {
+				dbuf.assign( obuf, printed );
+				dbuf.resize( printed+retval+1 );
+				vsnprintf( &dbuf[printed], retval+1, msg, ap_copy );
+				dbuf.resize( printed+retval );
+			} else
+				printed += TRACE_SNPRINTED(retval,sizeof(obuf)-printed);
+			va_end( ap_copy );
 		} else {
 			/* don't do any parsing for format specifiers in the msg -- tshow will
 			   also know to do this on the memory side of things */
 			retval = snprintf( &(obuf[printed]), sizeof(obuf)-printed, "%s", msg );
-			printed += TRACE_SNPRINTED(retval,sizeof(obuf)-printed);
+			if (retval >= 0 && static_cast<size_t>(retval) >= sizeof(obuf)-printed)
+				dbuf = std::string( obuf, printed ) + msg;
+			else
+				printed += TRACE_SNPRINTED(retval,sizeof(obuf)-printed);
 		}
-		if (obuf[printed-1] == '\n')
-			obuf[printed-1] = '\0';  // DONE w/ printed (don't need to decrement
-		outp = obuf;
-	} else {
-		if (msg[strlen(msg)-1] == '\n') { // need to copy to remove the trailing nl
-			retval = snprintf( obuf, sizeof(obuf), "%s", msg );
-			printed = TRACE_SNPRINTED(retval,sizeof(obuf));
+		if (!dbuf.empty()) {
+			if (dbuf.back() == '\n')
+				dbuf.pop_back();
+			outp = dbuf.c_str();
+		} else {
 			if (obuf[printed-1] == '\n')
 				obuf[printed-1] = '\0';  // DONE w/ printed (don't need to decrement
 			outp = obuf;
+		}
+	} else {
+		size_t len = strlen(msg);
+		if (msg[len-1] == '\n') { // need to copy to remove the trailing nl
+			if (len > sizeof(obuf)) {
+				dbuf.assign( msg, len-1 );
+				outp = dbuf.c_str();
+			} else {
+				retval = snprintf( obuf, sizeof(obuf), "%s", msg );
+				printed = TRACE_SNPRINTED(retval,sizeof(obuf));
+				if (obuf[printed-1] == '\n')
+					obuf[printed-1] = '\0';  // DONE w/ printed (don't need to decrement
+				outp = obuf;
+			}
 		} else
 			outp = msg;
 	}
-	// LocalContext args: 1-"package_name" 2-"file" 3-"line" 4-"pretty_function" 5-"include_stack"
-	ers::LocalContext lc(
-						 reinterpret_cast<char*>(idx2namsPtr(TID)),
-						 file, line, function, DEBUG_FORCED );
-	//std::ostringstream ers_report_impl_out_buffer;
-	//ers_report_impl_out_buffer << outp;
-	if (lvl < TLVL_DEBUG) { // NOTE: at least currently, TLVL_LOG is numerically 1 less than TLVL_DEBUG
-		//auto d = std::chrono::seconds{tvp->tv_sec} + std::chrono::microseconds{tvp->tv_usec};
-		////std::chrono::system_clock::time_point tp{std::chrono::duration_cast<std::chrono::system_clock::duration>(d)};
-		//std::chrono::system_clock::time_point tp{d};
-		// PROTECTED - ers::Issue iss( ers::Issue( ers::Severity(ers::Log), tp, lc, outp, std::vector<std::string>(), std::map<std::string,std::string>(), nullptr ));
-		ers::log(   ers::InternalMessage(lc,outp) );
-	} else {
-		ers::debug( ers::InternalMessage(lc,outp),lvl-TLVL_DEBUG );
-	}
+	dunedaq::logging::detail::report_slow_path( TID, lvl, file, line, function, outp );
 }
 
 SUPPRESS_NOT_USED_WARN
@@ -213,6 +266,8 @@ struct erstraceStream : public OutputStream {
 			case ers::Error:       lvl_=TLVL_ERROR;         break;
 			case ers::Fatal:       lvl_=TLVL_FATAL;         break;
 			}
+			if (dunedaq::logging::Recorder::enabled())
+				dunedaq::logging::Recorder::instance().record( lvl_, issue.message().size(), dunedaq::logging::Recorder::k_erstrace );
 			struct { char tn[TRACE_TN_BUFSZ]; } _trc_;
 			if (TRACE_INIT_CHECK(trace_name(TRACE_NAME,issue.context().file_name(),_trc_.tn,sizeof(_trc_.tn)))) {
 				if (traceControl_rwp->mode.bits.M && (traceLvls_p[traceTID].M & TLVLMSK(lvl_))) {
@@ -224,6 +279,11 @@ struct erstraceStream : public OutputStream {
 					lclTime.tv_usec = micros.count() % 1000000;
 					int traceID = trace_name2TID( trace_name(TRACE_NAME,issue.context().file_name(),_trc_.tn,sizeof(_trc_.tn)) );
 					std::string complete_message = issue.message();
+					if (dunedaq::logging::t_context.depth) {
+						char cbuf[dunedaq::logging::ThreadContext::k_stamp_max];
+						dunedaq::logging::context_format( cbuf, sizeof(cbuf) );
+						complete_message = "[" + std::string(cbuf) + "] " + complete_message;
+					}
 					const ers::Issue *issp = &issue;
 					while ((issp=issp->cause())) {
 						char fbuf[0x100], tbuf[0x40];
@@ -247,9 +307,10 @@ struct erstraceStream : public OutputStream {
 							+ ":" + std::to_string(issp->context().line_number())
 							+ "] " + issp->message();
 					}
-					trace(&lclTime, traceID, lvl_, issue.context().line_number(),
-					      issue.context().function_name(),
-					      0 TRACE_XTRA_PASSED, complete_message.c_str());
+					dunedaq::logging::append_stack( complete_message, dunedaq::logging::StackPolicy::mode(sev.type) );
+					// long messages/cause chains become continuation records (see Continuation.hxx)
+					dunedaq::logging::trace_chunked( &lclTime, traceID, lvl_, issue.context().line_number(),
+					                                 issue.context().function_name(), complete_message );
 				}
             }
 			chained().write( issue );
@@ -258,6 +319,17 @@ struct erstraceStream : public OutputStream {
 }
 ERS_REGISTER_OUTPUT_STREAM( ers::erstraceStream, "erstrace", ERS_EMPTY )    // last param is "param" 
 
+// ERS_REGISTER_OUTPUT_STREAM names its registrator "registrator", so it can be
+// used only once per compilation unit (above, for "erstrace").  The other streams
+// use this, which takes an identifier to make the registrator name unique.
+#define LOGGING_REGISTER_OUTPUT_STREAM( class_name, stream_name, param, id ) \
+	namespace { \
+		struct id##_stream_registrator_t { \
+			static ers::OutputStream * create( const std::string & param ) { return new class_name( param ); } \
+			id##_stream_registrator_t() { ers::OutputStreamFactory::instance().register_stream( stream_name, create ); } \
+		} id##_stream_registrator; \
+	}
+
 
 // Support macros
 #define SL_FRC(lvl) ((lvl)>=0 && (lvl)<TLVL_DEBUG)
@@ -0,0 +1,131 @@
+/**
+ * @file Recorder.hxx low overhead recording of the logging workload
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_RECORDER_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_RECORDER_HXX_
+
+#include <sys/syscall.h>		// SYS_gettid
+#include <unistd.h>				// syscall, getpid
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace dunedaq::logging {
+
+/*  File layout: WorkloadHeader followed by WorkloadRecords (host byte order).
+    Records of different threads are not in time order (each thread writes its
+    records in blocks).
+ */
+struct WorkloadHeader
+{
+	char     magic[8];			// "DDLOGREC"
+	uint32_t version;
+	uint32_t record_size;
+	int64_t  start_epoch_ns;	// system clock at ns==0
+};
+
+struct WorkloadRecord
+{
+	uint64_t ns;				// since the recording started (steady clock)
+	uint32_t tid;				// kernel thread id
+	uint16_t size;				// message size (saturated)
+	uint8_t  lvl;				// TRACE level (TLVL_*)
+	uint8_t  source;			// Recorder::Source
+};
+
+/**
+ * @brief Records time, thread, level and message size of the messages passing
+ * through verstrace_user() (TLOG()/TLOG_DEBUG() slow path) and
+ * erstraceStream::write() (ers:: methods).  Enabled with DUNEDAQ_LOGGING_RECORD
+ * (a file name; "%p" is replaced with the pid) in Logging::setup().  When not
+ * enabled the cost is an acquire atomic load (a plain load on x86).  Each
+ * thread buffers k_block records and appends them to the file under a mutex
+ * when the block is full and when the thread exits.  Replay with the
+ * replay_workload application.
+ */
+class Recorder
+{
+public:
+	enum Source : uint8_t { k_verstrace=0, k_erstrace=1 };
+	static const size_t k_block = 1024;
+
+	static Recorder& instance() { static Recorder s_rec; return s_rec; }
+	static bool      enabled()  { return s_enabled.load( std::memory_order_acquire ); }	// pairs with start()
+
+	bool start( std::string path )
+	{
+		size_t pp = path.find( "%p" );
+		if (pp != std::string::npos)
+			path.replace( pp, 2, std::to_string(getpid()) );
+		std::lock_guard<std::mutex> lk( m_mutex );
+		if (m_fp)
+			return false;
+		if (!(m_fp=fopen(path.c_str(),"wb")))
+			return false;
+		m_start = std::chrono::steady_clock::now();
+		WorkloadHeader hdr{ {'D','D','L','O','G','R','E','C'}, 1, sizeof(WorkloadRecord),
+		                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+		                        std::chrono::system_clock::now().time_since_epoch()).count() };
+		fwrite( &hdr, sizeof(hdr), 1, m_fp );
+		s_enabled.store( true, std::memory_order_release );	// publishes m_start
+		return true;
+	}
+
+	void record( uint8_t lvl, size_t size, Source source )
+	{
+		Block &blk = block();
+		if (!blk.tid)
+			blk.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+		blk.recs[blk.count++] = WorkloadRecord{
+			static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-m_start).count()),
+			blk.tid, static_cast<uint16_t>((size<0xffff) ? size : 0xffff), lvl, source };
+		if (blk.count == k_block)
+			write( blk );
+	}
+
+	~Recorder()
+	{
+		std::lock_guard<std::mutex> lk( m_mutex );
+		s_enabled.store( false, std::memory_order_relaxed );
+		if (m_fp) fclose( m_fp );
+		m_fp = nullptr;
+	}
+
+private:
+	struct Block
+	{
+		WorkloadRecord recs[k_block];
+		size_t         count = 0;
+		uint32_t       tid   = 0;
+		~Block() { if (count) Recorder::instance().write( *this ); }
+	};
+
+	Recorder() = default;
+
+	void write( Block &blk )
+	{
+		std::lock_guard<std::mutex> lk( m_mutex );
+		if (m_fp && blk.count)
+			fwrite( blk.recs, sizeof(WorkloadRecord), blk.count, m_fp );
+		blk.count = 0;
+	}
+
+	static Block& block() { static thread_local Block t_block; return t_block; }
+
+	static inline std::atomic<bool>    s_enabled{false};
+	std::mutex                          m_mutex;
+	FILE                               *m_fp = nullptr;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_RECORDER_HXX_
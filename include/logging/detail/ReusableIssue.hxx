@@ -0,0 +1,138 @@
+/**
+ * @file ReusableIssue.hxx reusable (in place updatable) issue handles
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_REUSABLEISSUE_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_REUSABLEISSUE_HXX_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace dunedaq::logging {
+
+/**
+ * @brief Common part of the <class_name>Reusable handles generated by the
+ * ERS_DECLARE_ISSUE/ERS_DECLARE_ISSUE_BASE overrides in internal/macro.hpp.
+ *
+ * The handle keeps the context (cloned once), the typed attributes and the
+ * formatted message.  update() only assigns the attributes; the message is
+ * re-formatted lazily into buffers which keep their capacity, so the TRACE
+ * memory path (TLOG()/TLOG_DEBUG() << handle) does not allocate once warmed up.
+ * An actual ers::Issue (with its own context copy, qualifiers and value map)
+ * is only built by issue() -- i.e. when the slow path (ERS) needs it.
+ * A handle is not thread safe; use one per thread.
+ */
+template <class IssueT>
+class ReusableIssue
+{
+public:
+	ReusableIssue( const ReusableIssue & ) = delete;
+	ReusableIssue & operator=( const ReusableIssue & ) = delete;
+	virtual ~ReusableIssue() = default;
+
+	const ers::Context & context() const { return *m_context; }
+	uint64_t             updates() const { return m_updates; }
+
+	const std::string & message() const
+	{
+		if (m_stale) {
+			m_buf.str( std::string() ); // keeps the capacity
+			m_out.flags( std::ios_base::dec | std::ios_base::skipws );
+			m_out.precision( 6 );
+			m_out.fill( ' ' );
+			format( m_out );
+			m_text.assign( m_buf.pbase(), m_buf.pptr() );
+			m_stale = false;
+		}
+		return m_text;
+	}
+
+protected:
+	explicit ReusableIssue( const ers::Context & context )
+		: m_context( context.clone() ), m_out( &m_buf ) {}
+
+	// generated from the message_ argument of the issue declaration
+	virtual void format( std::ostream & out ) const = 0;
+
+	void touch() { m_stale = true; ++m_updates; }
+
+private:
+	// expose the put area so the message can be copied without str()
+	struct Buffer : public std::stringbuf {
+		using std::stringbuf::pbase;
+		using std::stringbuf::pptr;
+	};
+
+	std::unique_ptr<ers::Context> m_context;
+	mutable Buffer       m_buf;
+	mutable std::ostream m_out;
+	mutable std::string  m_text;
+	mutable bool         m_stale   = true;
+	uint64_t             m_updates = 0;
+};
+
+/*  Storage of the attributes in the handles.  The declared type may be const,
+    a reference or not default constructible, so the value is kept in an
+    optional of the plain type; it is assigned in place when possible (keeping
+    e.g. a string's capacity) and re-constructed otherwise.
+ */
+template <class T>
+using attr_storage_t = std::optional<std::remove_cv_t<std::remove_reference_t<T>>>;
+
+template <class U, class V>
+inline void assign_attr( std::optional<U> & dst, const V & value )
+{
+	if constexpr (std::is_copy_assignable_v<U>) {
+		if (dst) {
+			*dst = value;
+			return;
+		}
+	}
+	dst.emplace( value );
+}
+
+namespace detail {
+/*  The base class part of the generated logging_format_message() functions:
+    the base classes declared with the overrides in internal/macro.hpp have
+    their own overload (found by ADL); ers::Issue adds nothing; for other
+    bases (e.g. declared in ers itself) the base issue is built for its message.
+ */
+inline void logging_format_message( std::ostream &, const ers::Issue *, const ers::Context & ) {}
+
+template <class BaseT, class... Args>
+inline void logging_format_message( std::ostream & out, const BaseT *, const ers::Context & context, const Args &... args )
+{
+	out << BaseT( context, args... ).message();
+}
+} // namespace detail
+
+/*  Used by the generated TraceStreamer operator<< for the handles.
+    Only the slow path (do_s) materializes an ers::Issue.
+ */
+template <class HandleT>
+inline TraceStreamer& reusable_issue_stream( TraceStreamer& x, const HandleT &r )
+{
+	if (x.do_m) {
+		x.line_ = r.context().line_number();
+		x.msg_append( r.message().c_str() );
+	}
+	if (x.do_s) {
+		if      (x.lvl_==TLVL_INFO) ers::info(  r.issue() );
+		else if (x.lvl_==TLVL_LOG)  ers::log(   r.issue() );
+		else                        ers::debug( r.issue(), x.lvl_-TLVL_DEBUG );
+		x.do_s = 0;
+	}
+	return x;
+}
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_REUSABLEISSUE_HXX_
@@ -0,0 +1,89 @@
+/**
+ * @file Snapshot.hxx copy-on-write snapshots read without locking
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_SNAPSHOT_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_SNAPSHOT_HXX_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dunedaq::logging {
+
+/**
+ * @brief A value which is read often (without locking) and changed rarely
+ * (under a mutex, by publishing a modified copy).  Readers announce themselves
+ * in a counter for the short time they use the value; replaced copies are
+ * retired and freed by a later update (or the destructor) when no reader is
+ * active, so a reader never sees a freed copy and old copies do not accumulate.
+ */
+template <class T>
+class Snapshot
+{
+public:
+	class Reader
+	{
+	public:
+		explicit Reader( const Snapshot &ss ) : m_snap(ss)
+		{
+			m_snap.m_readers.fetch_add( 1 );		// seq_cst: ordered before the load
+			m_value = m_snap.m_current.load();
+		}
+		~Reader() { m_snap.m_readers.fetch_sub( 1 ); }
+		Reader( const Reader & ) = delete;
+		Reader & operator=( const Reader & ) = delete;
+
+		const T & operator*()  const { return *m_value; }
+		const T * operator->() const { return m_value; }
+	private:
+		const Snapshot &m_snap;
+		const T        *m_value;
+	};
+
+	explicit Snapshot( std::unique_ptr<T> init = std::make_unique<T>() )
+		: m_current( init.release() ) {}
+	Snapshot( const Snapshot & ) = delete;
+	Snapshot & operator=( const Snapshot & ) = delete;
+	~Snapshot() { delete m_current.load(); }
+
+	Reader read() const { return Reader( *this ); }
+
+	/// fn(T&) modifies a copy of the current value, which is then published
+	template <class Fn>
+	void update( Fn fn )
+	{
+		std::lock_guard<std::mutex> lk( m_mutex );
+		auto next = std::make_unique<T>( *m_current.load() );
+		fn( *next );
+		publish( std::move(next) );
+	}
+
+	void replace( std::unique_ptr<T> next )
+	{
+		std::lock_guard<std::mutex> lk( m_mutex );
+		publish( std::move(next) );
+	}
+
+private:
+	void publish( std::unique_ptr<T> next )	// with m_mutex held
+	{
+		m_retired.emplace_back( m_current.exchange(next.release()) );	// seq_cst
+		// a reader which registers from now on loads the new value
+		if (m_readers.load() == 0)
+			m_retired.clear();
+	}
+
+	mutable std::atomic<unsigned>  m_readers{0};
+	std::atomic<const T*>          m_current;
+	std::mutex                     m_mutex;
+	std::vector<std::unique_ptr<const T>> m_retired;
+};
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_SNAPSHOT_HXX_
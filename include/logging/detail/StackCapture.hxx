@@ -0,0 +1,241 @@
+/**
+ * @file StackCapture.hxx per severity stack capture policy
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+#ifndef LOGGING_INCLUDE_LOGGING_DETAIL_STACKCAPTURE_HXX_
+#define LOGGING_INCLUDE_LOGGING_DETAIL_STACKCAPTURE_HXX_
+
+#include <errno.h>				// program_invocation_short_name
+#include <execinfo.h>			// backtrace
+#include <link.h>				// dl_iterate_phdr
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>				// offsetof
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dunedaq::logging {
+
+/*  Off  - nothing
+    Raw  - the return addresses are recorded (as module+offset, see LoadMap)
+           with the TRACE memory entry written by "erstrace" and, for log and
+           debug, appended to the slow path TLOG()/TLOG_DEBUG() message;
+           symbolize offline, e.g.:
+               addr2line -f -C -e <module> <offset-1>
+    Full - log and debug only: the ers::LocalContext of slow path TLOG()/
+           TLOG_DEBUG() messages is created with include_stack so the ERS
+           output streams print (symbolize) it.  An ers::Issue carries the
+           context it was created with, so for the other severities there is
+           nothing to attach the stack to -- Full is not accepted for them.
+ */
+enum class StackMode : uint8_t { Off=0, Raw=1, Full=2 };
+
+/**
+ * @brief Stack capture mode per ers severity type (Debug ... Fatal).
+ * Configured via DUNEDAQ_ERS_STACK (e.g. "warning=raw,error=raw,debug=full")
+ * in Logging::setup() or programmatically via set().
+ */
+class StackPolicy
+{
+public:
+	static StackMode mode( ers::severity type )
+	{
+		return static_cast<StackMode>(modes()[index(type)].load(std::memory_order_relaxed));
+	}
+	/// returns false (and changes nothing) for Full with a severity above Log
+	static bool set( ers::severity type, StackMode mode )
+	{
+		if (mode == StackMode::Full && index(type) > index(ers::Log))
+			return false;
+		modes()[index(type)].store( static_cast<uint8_t>(mode), std::memory_order_relaxed );
+		return true;
+	}
+
+	/// parse "severity=mode[,severity=mode...]"; returns false if any item is not understood
+	static bool configure( const std::string &spec )
+	{
+		static const char *sev_names[] = {"debug","log","info","warning","error","fatal"};
+		static const char *mode_names[] = {"off","raw","full"};
+		bool   ok=true;
+		size_t beg=0;
+		while (beg < spec.size()) {
+			size_t end = spec.find( ',', beg );
+			if (end == std::string::npos) end = spec.size();
+			std::string item = spec.substr( beg, end-beg );
+			beg = end+1;
+			size_t eq = item.find( '=' );
+			int sev=-1, mod=-1;
+			for (int ii=0; eq!=std::string::npos && ii<6; ++ii)
+				if (item.compare(0,eq,sev_names[ii]) == 0) sev=ii;
+			for (int ii=0; eq!=std::string::npos && ii<3; ++ii)
+				if (item.compare(eq+1,std::string::npos,mode_names[ii]) == 0) mod=ii;
+			if (sev<0 || mod<0 || !set(static_cast<ers::severity>(sev),static_cast<StackMode>(mod))) ok=false;
+		}
+		if (any_enabled())
+			warm_up();
+		return ok;
+	}
+
+	static bool any_enabled()
+	{
+		for (int ii=0; ii<6; ++ii)
+			if (modes()[ii].load(std::memory_order_relaxed)) return true;
+		return false;
+	}
+
+	// the first backtrace() call loads libgcc_s -- do that outside of the hot path
+	static void warm_up() { void *frm[2]; backtrace( frm, 2 ); }
+
+private:
+	static int index( ers::severity type ) { int ii=static_cast<int>(type); return (ii<0)?0:(ii>5)?5:ii; }
+	static std::atomic<uint8_t> *modes()
+	{
+		static std::atomic<uint8_t> s_modes[6] = {};
+		return s_modes;
+	}
+};
+
+/**
+ * @brief Snapshot of the executable segments of the loaded objects.  Maps a
+ * code address to module (basename) + offset from the module load address,
+ * which is what addr2line needs -- no symbol tables are read.  A lookup that
+ * misses rebuilds the snapshot only if objects were loaded or unloaded since
+ * (the dlpi_adds/dlpi_subs counters of dl_iterate_phdr).
+ */
+class LoadMap
+{
+public:
+	struct Segment { uintptr_t start; uintptr_t end; uintptr_t base; const char *name; };
+	using Segments = std::vector<Segment>;
+
+	static LoadMap& instance() { static LoadMap s_map; return s_map; }
+
+	bool lookup( uintptr_t addr, const char *&name, uintptr_t &offset )
+	{
+		for (int pass=0; pass<2; ++pass) {
+			{
+				auto segs = m_segs.read();
+				auto it = std::upper_bound( segs->begin(), segs->end(), addr,
+				                            [](uintptr_t aa, const Segment &ss) { return aa < ss.start; } );
+				if (it != segs->begin() && addr < (--it)->end) {
+					name   = it->name;		// (interned; outlives the snapshot)
+					offset = addr - it->base;
+					return true;
+				}
+			}
+			if (pass == 0 && !refresh_if_changed()) break;
+		}
+		return false;
+	}
+
+	/// returns true if the set of loaded objects changed (and the snapshot was rebuilt)
+	bool refresh_if_changed()
+	{
+		uint64_t gen = generation();
+		if (gen == m_generation.load(std::memory_order_acquire))
+			return false;
+		std::lock_guard<std::mutex> lk( m_mutex );
+		gen = generation();
+		if (gen == m_generation.load(std::memory_order_relaxed))
+			return true;	// another thread just rebuilt it
+		auto segs = std::make_unique<Segments>();
+		dl_iterate_phdr( [](struct dl_phdr_info *info, size_t, void *vp) -> int {
+				Segments   *sp  = static_cast<Segments*>(vp);
+				const char *nam = (info->dlpi_name && *info->dlpi_name) ? info->dlpi_name : program_invocation_short_name;
+				const char *sl  = strrchr( nam, '/' );
+				for (int ii=0; ii<info->dlpi_phnum; ++ii) {
+					const ElfW(Phdr) &ph = info->dlpi_phdr[ii];
+					if (ph.p_type == PT_LOAD && (ph.p_flags & PF_X))
+						sp->push_back( Segment{ info->dlpi_addr+ph.p_vaddr, info->dlpi_addr+ph.p_vaddr+ph.p_memsz,
+						                        info->dlpi_addr, intern(sl?sl+1:nam) } );
+				}
+				return 0;
+			}, segs.get() );
+		std::sort( segs->begin(), segs->end(), [](const Segment &aa, const Segment &bb) { return aa.start < bb.start; } );
+		m_segs.replace( std::move(segs) );
+		m_generation.store( gen, std::memory_order_release );
+		return true;
+	}
+
+private:
+	LoadMap() : m_segs( std::make_unique<Segments>() ) { refresh_if_changed(); }
+
+	// adds<<32 ^ subs of the loader; the first object is reported and iteration stops
+	static uint64_t generation()
+	{
+		uint64_t gen = 0;
+		dl_iterate_phdr( [](struct dl_phdr_info *info, size_t size, void *vp) -> int {
+				if (size >= offsetof(struct dl_phdr_info,dlpi_subs)+sizeof(info->dlpi_subs))
+					*static_cast<uint64_t*>(vp) = (info->dlpi_adds<<32) ^ info->dlpi_subs;
+				return 1;
+			}, &gen );
+		return gen ? gen : 1;	// (0 is "never built")
+	}
+
+	// a name handed out by lookup() stays valid after the snapshot is replaced
+	static const char *intern( const char *nam )
+	{
+		static std::vector<std::unique_ptr<std::string>> s_names;	// with m_mutex held
+		for (auto &nn : s_names)
+			if (*nn == nam) return nn->c_str();
+		s_names.push_back( std::make_unique<std::string>(nam) );
+		return s_names.back()->c_str();
+	}
+
+	std::mutex              m_mutex;
+	Snapshot<Segments>      m_segs;
+	std::atomic<uint64_t>   m_generation{0};
+};
+
+/*  Append "\n\tstack: mod+0xoff ..." (Raw and Full) for the current thread.  skip drops the innermost frames (this function is 1).
+    When called from an ERS output stream, the frames of the streams and of the
+    ERS library (libers) are dropped as well, so the stack starts at the caller
+    of ers::warning() etc.
+ */
+__attribute__((noinline)) inline void append_stack( std::string &out, StackMode mode, int skip=1 )
+{
+	static const int k_max_frames = 64;
+	static const int k_max_ers_frames = 16;		// stream chain + StreamManager
+	if (mode == StackMode::Off)
+		return;
+	void *frames[k_max_frames];
+	int nfrms = backtrace( frames, k_max_frames );
+	const char *mods[k_max_frames];
+	uintptr_t   offs[k_max_frames];
+	for (int ii=skip; ii<nfrms; ++ii)
+		if (!LoadMap::instance().lookup(reinterpret_cast<uintptr_t>(frames[ii]),mods[ii],offs[ii]))
+			mods[ii] = nullptr;
+	auto in_ers = [&mods](int ii) { return mods[ii] && strncmp(mods[ii],"libers.",7) == 0; };
+	int first = skip;
+	while (first < nfrms && first < skip+k_max_ers_frames && !in_ers(first))
+		++first;
+	if (first < nfrms && in_ers(first)) {
+		while (first < nfrms && in_ers(first))
+			++first;
+		skip = first;
+	}
+	char hex[2+16+1] = "0x";
+	auto hexstr = [&hex](uintptr_t vv) { *std::to_chars( hex+2, hex+sizeof(hex)-1, vv, 16 ).ptr = '\0'; return hex; };
+	out += "\n\tstack:";
+	for (int ii=skip; ii<nfrms; ++ii) {
+		uintptr_t addr = reinterpret_cast<uintptr_t>(frames[ii]);
+		out += ' ';
+		if (mods[ii]) {
+			out += mods[ii];
+			out += '+';
+			out += hexstr( offs[ii] );
+		} else
+			out += hexstr( addr );
+	}
+}
+
+} // namespace dunedaq::logging
+
+#endif // LOGGING_INCLUDE_LOGGING_DETAIL_STACKCAPTURE_HXX_
@@ -4,6 +4,19 @@
 #include "ers/internal/IssueDeclarationMacro.hpp"
 #include "ers/internal/macro.hpp"
 
+#include <boost/preprocessor/arithmetic/dec.hpp>
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/control/expr_if.hpp>
+#include <boost/preprocessor/control/if.hpp>
+#include <boost/preprocessor/facilities/is_empty.hpp>
+#include <boost/preprocessor/logical/not.hpp>
+#include <boost/preprocessor/punctuation/comma_if.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/seq/seq.hpp>
+#include <boost/preprocessor/stringize.hpp>
+#include <boost/preprocessor/tuple/elem.hpp>
+#include <type_traits>
+
 #undef TRACE_LOG_FUNCTION
 #define TRACE_LOG_FUNCTION erstrace_user
 
@@ -22,9 +35,9 @@
 # define TLOG(...)  TRACE_STREAMER(TLVL_LOG, \
                                    _tlog_ARG2(not_used, CHOOSE_(__VA_ARGS__)(__VA_ARGS__) 0,need_at_least_one), \
                                    _tlog_ARG3(not_used, CHOOSE_(__VA_ARGS__)(__VA_ARGS__) 0,"",need_at_least_one), \
-                                   1, 1)
+                                   1, 1) << dunedaq::logging::ContextStamp()
 #else
-# define TLOG(...)  TRACE_STREAMER(TLVL_LOG, TLOG2(__VA_ARGS__), 1)
+# define TLOG(...)  TRACE_STREAMER(TLVL_LOG, TLOG2(__VA_ARGS__), 1) << dunedaq::logging::ContextStamp()
 #endif
 
 // TRACE's TLOG_DEBUG maybe OK, depending on the version of TRACE - check at the end of this file
@@ -40,6 +53,84 @@
 #undef ERS_INFO
 #undef ERS_LOG
 
+//-----------------------------------------------------------------------------
+// Attribute helpers for the code added to the ERS issue declarations below.
+// An attribute is "(type)name"; the attribute sequences are walked with a
+// leading (~) sentinel so that ERS_EMPTY (no attributes) also works.
+// The macro given to LOGGING_ATTR_FOR_EACH is called as m(r, data, i, attr)
+// with i the 0-based index of the attribute.
+#define LOGGING_ATTR_TYPE(attr)          BOOST_PP_SEQ_HEAD(attr)
+#define LOGGING_ATTR_NAME(attr)          BOOST_PP_SEQ_TAIL(attr)
+#define LOGGING_ATTR_MEMBER(attr)        BOOST_PP_CAT(m_attr_, LOGGING_ATTR_NAME(attr))
+#define LOGGING_ATTR_FOR_EACH(m, data, attributes) \
+	BOOST_PP_SEQ_FOR_EACH_I(LOGGING_ATTR_DISPATCH_, (m, data), (~) ERS_EMPTY attributes)
+#define LOGGING_ATTR_DISPATCH_(r, md, i, attr) \
+	BOOST_PP_IF(i, BOOST_PP_TUPLE_ELEM(2, 0, md), LOGGING_ATTR_SKIP_)(r, BOOST_PP_TUPLE_ELEM(2, 1, md), BOOST_PP_DEC(i), attr)
+#define LOGGING_ATTR_SKIP_(r, data, i, attr)
+
+#define LOGGING_ATTR_COMMA_PARAM_(r, data, i, attr) , LOGGING_ATTR_TYPE(attr) LOGGING_ATTR_NAME(attr)
+#define LOGGING_ATTR_CREF_PARAM_(r, data, i, attr) BOOST_PP_COMMA_IF(i) std::add_lvalue_reference_t<std::add_const_t<LOGGING_ATTR_TYPE(attr)>> LOGGING_ATTR_NAME(attr)
+#define LOGGING_ATTR_COMMA_CREF_PARAM_(r, data, i, attr) , std::add_lvalue_reference_t<std::add_const_t<LOGGING_ATTR_TYPE(attr)>> LOGGING_ATTR_NAME(attr)
+#define LOGGING_ATTR_ARG_(r, data, i, attr)        BOOST_PP_COMMA_IF(i) LOGGING_ATTR_NAME(attr)
+#define LOGGING_ATTR_COMMA_ARG_(r, data, i, attr)  , LOGGING_ATTR_NAME(attr)
+#define LOGGING_ATTR_VOID_(r, data, i, attr)       (void)LOGGING_ATTR_NAME(attr);
+#define LOGGING_ATTR_MEMBER_ARG_(r, data, i, attr) , *LOGGING_ATTR_MEMBER(attr)
+#define LOGGING_ATTR_DECLARE_(r, data, i, attr)    dunedaq::logging::attr_storage_t<LOGGING_ATTR_TYPE(attr)> LOGGING_ATTR_MEMBER(attr);
+#define LOGGING_ATTR_ASSIGN_(r, data, i, attr)     dunedaq::logging::assign_attr( LOGGING_ATTR_MEMBER(attr), LOGGING_ATTR_NAME(attr) );
+#define LOGGING_ATTR_JSON_(r, data, i, attr) \
+	dunedaq::logging::json::append_attr_text<LOGGING_ATTR_TYPE(attr)>( out, BOOST_PP_STRINGIZE(LOGGING_ATTR_NAME(attr)), data );
+
+/** Added to each declared issue class (in namespace_name):
+    - logging_format_message(out, (const class_name*)nullptr, context, attrs...)
+      -- writes the message as the class constructor builds it: message_
+      followed by the message of base_class_name (found by ADL on the tag; see
+      dunedaq::logging::detail::logging_format_message for the other bases)
+    - class_nameReusable -- a handle whose attributes can be updated in place
+      (see logging/detail/ReusableIssue.hxx), e.g.:
+          static thread_local ProgressUpdateReusable pu( ERS_HERE, "", "" );
+          TLOG_DEBUG(5) << pu.update( name, msg );
+    - logging_json_serialize(out, issue) -- appends the typed attributes as JSON
+      fields for the "json" ERS stream (see logging/detail/JsonStream.hxx); it
+      is registered under class_name::get_uid() during static initialization
+ */
+#define __LOGGING_DECLARE_ISSUE_EXTRAS__( namespace_name, class_name, base_class_name, message_, base_attributes, attributes_ ) \
+	__LOGGING_DECLARE_ISSUE_EXTRAS_IMPL__( namespace_name, class_name, base_class_name, message_, base_attributes, base_attributes attributes_ )
+#define __LOGGING_DECLARE_ISSUE_EXTRAS_IMPL__( namespace_name, class_name, base_class_name, message_, base_attributes, attributes ) \
+	namespace namespace_name {					\
+	  inline void logging_format_message( std::ostream & out, const class_name *, const ers::Context & context \
+	              LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_COMMA_CREF_PARAM_, ~, attributes) ) \
+	    { LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_VOID_, ~, attributes)     \
+	      BOOST_PP_EXPR_IF(BOOST_PP_NOT(BOOST_PP_IS_EMPTY(message_)), out << message_;) \
+	      using dunedaq::logging::detail::logging_format_message;      \
+	      logging_format_message( out, static_cast<const base_class_name *>(nullptr), context \
+	                              LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_COMMA_ARG_, ~, base_attributes) ); } \
+	  class BOOST_PP_CAT(class_name, Reusable) : public dunedaq::logging::ReusableIssue<class_name> \
+	  {                                                                 \
+	  public:                                                           \
+	    explicit BOOST_PP_CAT(class_name, Reusable)( const ers::Context & context \
+	              LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_COMMA_PARAM_, ~, attributes) ) \
+	      : dunedaq::logging::ReusableIssue<class_name>( context )      \
+	      { update( LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_ARG_, ~, attributes) ); } \
+	    BOOST_PP_CAT(class_name, Reusable) & update( LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_CREF_PARAM_, ~, attributes) ) \
+	      { LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_ASSIGN_, ~, attributes) touch(); return *this; } \
+	    class_name issue() const                                        \
+	      { return class_name( context() LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_MEMBER_ARG_, ~, attributes) ); } \
+	  protected:                                                        \
+	    void format( std::ostream & out ) const override                \
+	      { logging_format_message( out, static_cast<const class_name *>(nullptr), context() \
+	                                LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_MEMBER_ARG_, ~, attributes) ); } \
+	  private:                                                          \
+	    LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_DECLARE_, ~, attributes)     \
+	  };                                                                \
+	  static inline TraceStreamer& operator<<(TraceStreamer& x, const BOOST_PP_CAT(class_name, Reusable) &r) \
+	    { return dunedaq::logging::reusable_issue_stream( x, r ); }    \
+	  inline void logging_json_serialize( std::string & out, const class_name & iss ) \
+	    { const auto & params = iss.parameters();                      \
+	      LOGGING_ATTR_FOR_EACH(LOGGING_ATTR_JSON_, params, attributes) (void)out; (void)params; } \
+	  inline const bool BOOST_PP_CAT(logging_json_registered_, class_name) = \
+	    dunedaq::logging::json::register_serializer( class_name::get_uid(), \
+	      []( std::string & out, const ers::Issue & iss ) { logging_json_serialize( out, static_cast<const class_name &>(iss) ); } ); \
+	}
 
 # undef  ERS_DECLARE_ISSUE_BASE
 # define ERS_DECLARE_ISSUE_BASE(           namespace_name, class_name, base_class_name, message_, base_attributes, attributes ) \
@@ -59,7 +150,8 @@
                  }                                                      \
                  return x;                                              \
                 } \
-	}
+	}                                                                   \
+	__LOGGING_DECLARE_ISSUE_EXTRAS__( namespace_name, class_name, base_class_name, message_, base_attributes, attributes )
 
 # undef  ERS_DECLARE_ISSUE
 # define ERS_DECLARE_ISSUE(                namespace_name, class_name,                       message_,            attributes ) \
@@ -79,6 +171,7 @@
                  }                                                      \
                  return x; \
                 } \
-	}
+	}                                                                   \
+	__LOGGING_DECLARE_ISSUE_EXTRAS__( namespace_name, class_name, ers::Issue, ERS_EMPTY message_, ERS_EMPTY, attributes )
 
 #endif // LOGGING_INCLUDE_LOGGING_INTERNAL_MACRO_HPP_
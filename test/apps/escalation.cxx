@@ -0,0 +1,120 @@
+/**
+ * @file escalation.cxx - check the "escalate" ERS stream (see logging/detail/Escalation.hxx)
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ *
+ */
+const char *usage = R"foo(
+  usage: %s [option]    # raise errors and check the TRACE level escalation
+example: %s
+options:
+ --help, -h       - print this help
+ --history, -H    - print the escalation history at the end
+DUNEDAQ_ERS_ESCALATE is set to "1,5,MS,2" (1 second, debug levels 0-5, memory and
+slow path, at most once per 2 seconds). The memory and slow level masks of this
+file's TRACE name are checked before, during and after the escalation, as are
+the rate limit and the history. Takes about 4 seconds; exits non-zero on failure.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]))
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+
+#include <logging/Logging.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+
+ERS_DECLARE_ISSUE(ERS_EMPTY,                        // namespace ERS_EMPTY ==> anonymous
+                  EscalationTest,                   // issue class name
+                  "escalation test error " << nn,
+                  ((int)nn)
+                  )
+
+using dunedaq::logging::Escalator;
+
+static int g_failures=0;
+
+static void check( bool ok, const char *what )
+{
+	printf( "%-4s %s\n", ok?"ok":"FAIL", what );
+	if (!ok) ++g_failures;
+}
+
+int main(int argc, char *argv[])
+{
+	int opt_help=0, opt_history=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,  nullptr,   'h' },
+			{ "history",  no_argument,  nullptr,   'H' },
+			{  nullptr,   0,            nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hH",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;     break;
+		case 'H':           opt_history=1;  break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help) { USAGE(); exit(0); }
+
+	setenv( "DUNEDAQ_ERS_ERROR", "erstrace", 1 );	// no console output
+	setenv( "DUNEDAQ_ERS_ESCALATE", "1,5,MS,2", 1 );
+	dunedaq::logging::Logging::setup("test", "escalation");
+
+	// the TRACE name the escalate stream uses for issues from this file
+	struct { char tn[TRACE_TN_BUFSZ]; } _trc_;
+	if (!TRACE_INIT_CHECK(trace_name(TRACE_NAME,__FILE__,_trc_.tn,sizeof(_trc_.tn)))) {
+		printf( "FAIL TRACE initialization\n" );
+		return (1);
+	}
+	int tid = trace_name2TID( trace_name(TRACE_NAME,__FILE__,_trc_.tn,sizeof(_trc_.tn)) );
+	const uint64_t dbgmsk = ((1ULL<<(5+TLVL_DEBUG+1))-1) & ~((1ULL<<TLVL_DEBUG)-1);	// TLOG_DEBUG(0..5)
+	const uint64_t keep   = 1ULL<<(TLVL_DEBUG+2);	// already enabled -- must survive the restore
+	traceLvls_p[tid].M = (traceLvls_p[tid].M & ~dbgmsk) | keep;
+	traceLvls_p[tid].S &= ~dbgmsk;
+	auto raised = [&]() { return (traceLvls_p[tid].M & dbgmsk) == dbgmsk && (traceLvls_p[tid].S & dbgmsk) == dbgmsk; };
+	auto normal = [&]() { return (traceLvls_p[tid].M & dbgmsk) == keep && (traceLvls_p[tid].S & dbgmsk) == 0; };
+
+	check( normal(), "before: debug levels 0-5 not enabled (except 2 in M)" );
+
+	ers::error( EscalationTest(ERS_HERE,1) );
+	check( raised(), "error: debug levels 0-5 enabled in M and S" );
+	check( Escalator::instance().history().size() == 1, "error: history has the raise" );
+
+	ers::error( EscalationTest(ERS_HERE,2) );
+	check( Escalator::instance().suppressed() == 1, "second error within min_interval: rate limited" );
+	check( Escalator::instance().history().size() == 1, "second error within min_interval: no history entry" );
+
+	std::this_thread::sleep_for( std::chrono::milliseconds(1500) );
+	check( normal(), "after 1.5 s: levels restored, level 2 in M still enabled" );
+	auto hist = Escalator::instance().history();
+	check( hist.size() == 2 && hist.back().restore, "after 1.5 s: history has the restore" );
+	check( hist.size() == 2 && hist.front().added_M == (dbgmsk & ~keep) && hist.front().added_S == dbgmsk,
+	       "after 1.5 s: history has the bits which were added" );
+
+	ers::error( EscalationTest(ERS_HERE,3) );
+	check( normal() && Escalator::instance().suppressed() == 2, "error 1.5 s after the first: rate limited" );
+
+	std::this_thread::sleep_for( std::chrono::milliseconds(1000) );
+	ers::error( EscalationTest(ERS_HERE,4) );
+	check( raised(), "error 2.5 s after the first: escalated again" );
+	std::this_thread::sleep_for( std::chrono::milliseconds(1500) );
+	check( normal() && Escalator::instance().history().size() == 4, "after another 1.5 s: restored again" );
+
+	if (opt_history)
+		for (const auto &ch : Escalator::instance().history()) {
+			time_t tt = std::chrono::system_clock::to_time_t( ch.when );
+			char tbuf[0x40];
+			strftime( tbuf, sizeof(tbuf), "%H:%M:%S", localtime(&tt) );
+			printf( "%s %-8s %s M 0x%llx S 0x%llx\n", tbuf, ch.restore?"restored":"raised", ch.name.c_str(),
+			        static_cast<unsigned long long>(ch.added_M), static_cast<unsigned long long>(ch.added_S) );
+		}
+	printf( "%d failure(s)\n", g_failures );
+	return (g_failures ? 1 : 0);
+}   // main
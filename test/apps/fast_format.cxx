@@ -0,0 +1,116 @@
+/**
+ * @file fast_format.cxx - compare the std::to_chars based inserters (detail/Format.hxx)
+ *                         with the default (ostream style) TraceStreamer formatting
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option]    # time TLOG_DEBUG formatting of numbers and containers
+example: %s -l 100000
+options:
+ --help, -h       - print this help
+ --loops, -l      - loops for each mode
+ --slow, -s       - also enable the slow path (ERS) for the debug level
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <chrono>
+#include <string>
+#include <vector>
+#include <logging/Logging.hpp>
+
+std::ostream&
+operator<<(std::ostream& t, std::vector<int> ints)
+{
+  t << "{";
+  bool first = true;
+  for (auto& i : ints) {
+    if (!first)
+      t << ", ";
+    first = false;
+    t << i;
+  }
+  return t << "}";
+}
+
+static void report( const char *what, int loops, std::chrono::steady_clock::duration dur )
+{
+	double ns = std::chrono::duration<double,std::nano>(dur).count();
+	printf( "%-24s %10.1f ns/msg %12.0f msgs/s\n", what, ns/loops, loops/(ns*1e-9) );
+}
+
+
+int main(int argc, char *argv[])
+{
+	using namespace dunedaq::logging;
+	static const int dbglvl=1;
+	int loops=100000;
+	int opt_help=0, opt_slow=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "loops",    required_argument, nullptr,   'l' },
+			{ "slow",     no_argument,       nullptr,   's' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hl:s",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                                           break;
+		case 'l':           loops   =static_cast<int>(strtoul(optarg,nullptr,0)); break;
+		case 's':           opt_slow=1;                                           break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help) { USAGE(); exit(0); }
+
+	setenv("TRACE_LVLM",std::to_string(1ULL<<(TLVL_DEBUG+dbglvl)).c_str(),0);
+	if (opt_slow)
+		setenv("TRACE_LVLS",std::to_string(1ULL<<(TLVL_DEBUG+dbglvl)).c_str(),0);
+	Logging::setup("test", "fast_format");
+
+	std::vector<int> adcs(100);
+	for (size_t ii=0; ii<adcs.size(); ++ii)
+		adcs[ii] = static_cast<int>(ii*37 % 4096);
+	size_t thread_idx=3;
+	double temp=36.6;
+	TLOG_DEBUG(dbglvl) << "warm up";
+
+	auto t0=std::chrono::steady_clock::now();
+	for (int uu=0; uu<loops; ++uu)
+		TLOG_DEBUG(dbglvl) << "tidx " << thread_idx << " fast LOG_DEBUG(" << dbglvl << ") #" << uu << " t=" << temp
+		                   << " addr=" << std::hex << uu << std::dec;
+	report( "scalars ostream", loops, std::chrono::steady_clock::now()-t0 );
+
+	t0=std::chrono::steady_clock::now();
+	for (int uu=0; uu<loops; ++uu)
+		TLOG_DEBUG(dbglvl) << "tidx " << dec(thread_idx) << " fast LOG_DEBUG(" << dec(dbglvl) << ") #" << dec(uu)
+		                   << " t=" << flt(temp) << " addr=" << hex(uu);
+	report( "scalars to_chars", loops, std::chrono::steady_clock::now()-t0 );
+
+	t0=std::chrono::steady_clock::now();
+	for (int uu=0; uu<loops; ++uu) {
+		std::ostringstream oss;
+		oss << adcs;
+		TLOG_DEBUG(dbglvl) << "adcs " << oss.str();
+	}
+	report( "vector<int> ostream", loops, std::chrono::steady_clock::now()-t0 );
+
+	t0=std::chrono::steady_clock::now();
+	for (int uu=0; uu<loops; ++uu)
+		TLOG_DEBUG(dbglvl) << "adcs " << span(adcs, adcs.size());
+	report( "vector<int> span", loops, std::chrono::steady_clock::now()-t0 );
+
+	t0=std::chrono::steady_clock::now();
+	for (int uu=0; uu<loops; ++uu)
+		TLOG_DEBUG(dbglvl) << "adcs " << span(adcs, 16) << " took " << dur(std::chrono::microseconds(uu));
+	report( "span(16) + dur", loops, std::chrono::steady_clock::now()-t0 );
+
+	return (0);
+}   // main
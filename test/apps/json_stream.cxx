@@ -0,0 +1,140 @@
+/**
+ * @file json_stream.cxx - cost of the "json" ERS stream compared to "lstdout"
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option]    # compare the json and lstdout ERS streams
+example: %s --loops=200000
+options:
+ --help, -h       - print this help
+ --loops, -l      - messages per measurement (default 100000)
+ --show, -s       - print one json line (to stderr) and exit
+The escaping is measured for the scalar, SWAR and (if available) SSE2 versions.
+Each stream is then measured in its own process, as DUNEDAQ_ERS_INFO, with
+stdout redirected to /dev/null.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <sys/wait.h>           // waitpid
+#include <unistd.h>             // fork
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <logging/Logging.hpp>
+
+ERS_DECLARE_ISSUE(ERS_EMPTY,                        // namespace ERS_EMPTY ==> anonymous
+                  BenchIssue,                       // issue class name
+                  "link " << link << " rate " << rate << " Hz: " << detail,
+                  ((int)link) ((double)rate) ((std::string)detail)
+                  )
+
+using steady = std::chrono::steady_clock;
+using dunedaq::logging::json::detail::append_escaped_with;
+
+static double ns_since( steady::time_point t0 )
+{
+	return std::chrono::duration<double,std::nano>( steady::now()-t0 ).count();
+}
+
+template <const char *(*Find)(const char *, const char *)>
+static double escape_gbps( const std::string &text, int loops )
+{
+	std::string out;
+	out.reserve( 2*text.size() );
+	auto t0 = steady::now();
+	for (int ii=0; ii<loops; ++ii) {
+		out.clear();
+		append_escaped_with<Find>( out, text.data(), text.size() );
+		__asm__ __volatile__("" : : "r"(out.data()) : "memory");
+	}
+	return static_cast<double>(text.size())*loops/ns_since(t0);
+}
+
+// run in a child process so each gets its own ERS stream configuration
+static void measure_stream( const char *stream, int loops )
+{
+	pid_t pid = fork();
+	if (pid == 0) {
+		setenv( "DUNEDAQ_ERS_INFO", stream, 1 );
+		dunedaq::logging::Logging::setup("test", "json_stream");
+		if (!freopen("/dev/null","w",stdout)) _exit(1);
+		BenchIssue iss( ERS_HERE, 7, 1234.5, "frame \"42\" late\tby 3 ticks" );
+		auto t0 = steady::now();
+		for (int ii=0; ii<loops; ++ii)
+			ers::info( iss );
+		fflush( stdout );
+		fprintf( stderr, "%-8s %10.1f ns/msg\n", stream, ns_since(t0)/loops );
+		_exit(0);
+	}
+	int status;
+	waitpid( pid, &status, 0 );
+}
+
+
+int main(int argc, char *argv[])
+{
+	int loops=100000, opt_help=0, opt_show=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "loops",    required_argument, nullptr,   'l' },
+			{ "show",     no_argument,       nullptr,   's' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hl:s",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                          break;
+		case 'l':           loops=strtoul(optarg,nullptr,0);     break;
+		case 's':           opt_show=1;                          break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help || loops <= 0) { USAGE(); exit(opt_help?0:1); }
+
+	if (opt_show) {
+		std::string line;
+		BenchIssue cause( ERS_HERE, 3, 0.5, "cause" );
+		dunedaq::logging::json::append_issue( line, BenchIssue(ERS_HERE, 7, 1234.5, "frame \"42\"\n", cause) );
+		fprintf( stderr, "%s\n", line.c_str() );
+		return (0);
+	}
+
+	fprintf( stderr, "escaping (GB/s)   %10s %10s %10s\n", "scalar", "swar", "sse2" );
+	for (size_t len : {64, 256, 1024}) {
+		for (int specials : {0, 1}) {
+			std::string text;
+			for (size_t ii=0; ii<len; ++ii)		// ~2% to be escaped when specials
+				text += (specials && ii%50 == 49) ? '"' : static_cast<char>('a'+ii%26);
+			int nn = static_cast<int>(loops*(1024/len));
+			fprintf( stderr, "%5zu bytes %-6s %10.2f %10.2f", len, specials?"2%esc":"plain",
+			         escape_gbps<dunedaq::logging::json::detail::find_escape_scalar>(text,nn),
+			         escape_gbps<dunedaq::logging::json::detail::find_escape_swar>(text,nn) );
+#if defined(__SSE2__)
+			fprintf( stderr, " %10.2f\n", escape_gbps<dunedaq::logging::json::detail::find_escape_sse2>(text,nn) );
+#else
+			fprintf( stderr, " %10s\n", "n/a" );
+#endif
+		}
+	}
+
+	BenchIssue iss( ERS_HERE, 7, 1234.5, "frame \"42\" late\tby 3 ticks" );
+	std::string line;
+	auto t0 = steady::now();
+	for (int ii=0; ii<loops; ++ii) {
+		line.clear();
+		dunedaq::logging::json::append_issue( line, iss );
+	}
+	fprintf( stderr, "serialize only %10.1f ns/msg (%zu bytes)\n", ns_since(t0)/loops, line.size() );
+
+	measure_stream( "lstdout", loops );
+	measure_stream( "json", loops );
+	return (0);
+}   // main
@@ -14,10 +14,12 @@ options:
  --loops, -l      - loops each thread
  --threads, -t    - threads in addition to main
  --do-issue, -i   - use issue
+ --batch, -b      - emit the thread messages in batches of this size (TLOG_DEBUG_BATCH)
 )foo""\n";
 #define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
 
 #include <getopt.h>             // getopt_long
+#include <chrono>
 #include <vector>
 #include <thread>
 #include <logging/Logging.hpp>
@@ -33,6 +35,7 @@ ERS_DECLARE_ISSUE(ERS_EMPTY,                                           // namesp
 static int g_dbglvl=6;
 static int g_loops=2;
 static int g_do_issue=0;
+static int g_batch=0;
 
 void thread_func( volatile const int *spinlock, size_t thread_idx )
 {
@@ -44,6 +47,12 @@ void thread_func( volatile const int *spinlock, size_t thread_idx )
 	if (g_do_issue) {
 		for (auto uu=0; uu<g_loops; ++uu)
 			ers::debug( TestIssue( ERS_HERE, thread_idx, lcllvl, uu ), lcllvl );
+	} else if (g_batch) {
+		for (auto uu=0; uu<g_loops; ) {
+			auto batch = TLOG_DEBUG_BATCH(lcllvl);
+			for (auto bb=0; bb<g_batch && uu<g_loops; ++bb, ++uu)
+				batch.add() << "tidx " << thread_idx << " fast LOG_DEBUG(" << lcllvl << ") #" <<uu;
+		}
 	} else {
 		for (auto uu=0; uu<g_loops; ++uu)
 			TLOG_DEBUG(lcllvl) << "tidx " << thread_idx << " fast LOG_DEBUG(" << lcllvl << ") #" <<uu;
@@ -65,15 +74,17 @@ int main(int argc, char *argv[])
 			{ "loops",    required_argument, nullptr,   'l' },
 			{ "threads",  required_argument, nullptr,   't' },
 			{ "do-issue", no_argument,       nullptr,   'i' },
+			{ "batch",    required_argument, nullptr,   'b' },
 			{  nullptr,   0,                 nullptr,    0  }
 		};
-		int opt = getopt_long( argc, argv, "?hil:t:x",long_options, nullptr );
+		int opt = getopt_long( argc, argv, "?hib:l:t:x",long_options, nullptr );
 		if (opt == -1) break;
 		switch (opt) {
 		case '?': case 'h': opt_help   =1;                                          break;
 		case 'l':           g_loops    =static_cast<int>(strtoul(optarg,nullptr,0));break;
 		case 't':           num_threads=static_cast<int>(strtoul(optarg,nullptr,0));break;
 		case 'i':           g_do_issue=1;                                           break;
+		case 'b':           g_batch    =static_cast<int>(strtoul(optarg,nullptr,0));break;
 		default:
 			TLOG() << "?? getopt returned character code 0" << std::oct << opt;
 			opt_help=1;
@@ -87,6 +98,7 @@ int main(int argc, char *argv[])
 		threads[ss] = std::thread(thread_func,&spinlock,ss);
 
 	usleep(20000);
+	auto t0=std::chrono::steady_clock::now();
 	spinlock = 0;
 	if (g_do_issue) {
 		for (int ii=0; ii<g_loops; ++ii)
@@ -98,5 +110,9 @@ int main(int argc, char *argv[])
 
 	for (std::thread& tt : threads)
 		tt.join();
+	double secs = std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+	size_t msgs = static_cast<size_t>(g_loops)*(threads.size()+1);
+	printf( "%zu messages (%s) in %.6f s = %.0f msgs/s\n", msgs,
+	        g_do_issue?"issue":g_batch?("batch of "+std::to_string(g_batch)).c_str():"single", secs, msgs/secs );
 	return (0);
 }   // main
@@ -0,0 +1,131 @@
+/**
+ * @file reusable_issue.cxx - compare constructing an issue per message with
+ *                            updating a <class_name>Reusable handle in place
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option]    # count allocations and time per TLOG_DEBUG << issue
+example: %s -l 100000
+options:
+ --help, -h       - print this help
+ --loops, -l      - loops for each mode
+ --slow, -s       - also enable the slow path (ERS) for the debug level
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <atomic>
+#include <chrono>
+#include <cstdlib>              // malloc, free
+#include <new>
+#include <string>
+#include <logging/Logging.hpp>
+
+ERS_DECLARE_ISSUE(appfwk,                 ///< Namespace
+                  GeneralDAQModuleIssue,  ///< Issue class name
+                  " DAQModule: " << name, ///< Message
+                  ((std::string)name)     ///< Message parameters
+)
+
+ERS_DECLARE_ISSUE_BASE(logging,
+                       ProgressUpdate,
+                       appfwk::GeneralDAQModuleIssue,
+                       message,
+                       ((std::string)name),
+                       ((std::string)message))
+
+ERS_DECLARE_ISSUE(ERS_EMPTY,                                           // namespace ERS_EMPTY ==> anonymous
+                  TestIssue,                        // issue class name
+                  "Three arg TestIssue - arg 1: " << arg1 << " arg 2: " << arg2 << " arg 3: " << arg3,
+                  ((size_t)arg1) ((int)arg2) ((int)arg3)
+                  )
+
+
+static std::atomic<uint64_t> g_allocs{0};
+
+void* operator new(size_t sz)
+{
+	++g_allocs;
+	if (void *ptr = malloc(sz ? sz : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept              { free(ptr); }
+void operator delete(void *ptr, size_t /*sz*/) noexcept { free(ptr); }
+
+
+static void report( const char *what, int loops, uint64_t allocs, std::chrono::steady_clock::duration dur )
+{
+	double ns = std::chrono::duration<double,std::nano>(dur).count();
+	printf( "%-28s %8.2f allocs/msg %10.1f ns/msg %12.0f msgs/s\n", what,
+	        static_cast<double>(allocs)/loops, ns/loops, loops/(ns*1e-9) );
+}
+
+
+int main(int argc, char *argv[])
+{
+	static const int dbglvl=1;
+	int loops=100000;
+	int opt_help=0, opt_slow=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "loops",    required_argument, nullptr,   'l' },
+			{ "slow",     no_argument,       nullptr,   's' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hl:s",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                                           break;
+		case 'l':           loops   =static_cast<int>(strtoul(optarg,nullptr,0)); break;
+		case 's':           opt_slow=1;                                           break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help) { USAGE(); exit(0); }
+
+	// make sure the specific debug lvl used is enabled for the memory (and optionally slow) path
+	setenv("TRACE_LVLM",std::to_string(1ULL<<(TLVL_DEBUG+dbglvl)).c_str(),0);
+	if (opt_slow)
+		setenv("TRACE_LVLS",std::to_string(1ULL<<(TLVL_DEBUG+dbglvl)).c_str(),0);
+	dunedaq::logging::Logging::setup("test", "reusable_issue");
+
+	std::string name="someName";
+	std::string msg="Generated list with contents {1, 2, 3} and size 3. ";
+	TLOG_DEBUG(dbglvl) << "warm up";
+
+	uint64_t a0=g_allocs;
+	auto t0=std::chrono::steady_clock::now();
+	for (int ii=0; ii<loops; ++ii)
+		TLOG_DEBUG(dbglvl) << logging::ProgressUpdate( ERS_HERE, name, msg );
+	report( "ProgressUpdate construct", loops, g_allocs-a0, std::chrono::steady_clock::now()-t0 );
+
+	logging::ProgressUpdateReusable pu( ERS_HERE, name, msg );
+	a0=g_allocs;
+	t0=std::chrono::steady_clock::now();
+	for (int ii=0; ii<loops; ++ii)
+		TLOG_DEBUG(dbglvl) << pu.update( name, msg );
+	report( "ProgressUpdateReusable", loops, g_allocs-a0, std::chrono::steady_clock::now()-t0 );
+
+	a0=g_allocs;
+	t0=std::chrono::steady_clock::now();
+	for (int ii=0; ii<loops; ++ii)
+		TLOG_DEBUG(dbglvl) << TestIssue( ERS_HERE, 1, dbglvl, ii );
+	report( "TestIssue construct", loops, g_allocs-a0, std::chrono::steady_clock::now()-t0 );
+
+	TestIssueReusable ti( ERS_HERE, 1, dbglvl, 0 );
+	a0=g_allocs;
+	t0=std::chrono::steady_clock::now();
+	for (int ii=0; ii<loops; ++ii)
+		TLOG_DEBUG(dbglvl) << ti.update( 1, dbglvl, ii );
+	report( "TestIssueReusable", loops, g_allocs-a0, std::chrono::steady_clock::now()-t0 );
+
+	return (0);
+}   // main
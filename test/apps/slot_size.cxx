@@ -0,0 +1,205 @@
+/**
+ * @file slot_size.cxx - TRACE memory entry size vs. history trade-off with
+ *                       continuation records (see logging/detail/Continuation.hxx)
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option]    # compare TRACE message sizes (TRACE_MSGMAX)
+example: %s --record=/tmp/logging_workload_1234.rec
+options:
+ --help, -h       - print this help
+ --record, -r     - take the message sizes (and rate) from a DUNEDAQ_LOGGING_RECORD file
+ --msgs, -n       - number of synthetic messages (default 1000000) when no record
+ --memory, -m     - memory for the entries in MB (default 64)
+ --hdr-size, -H   - bytes of an entry in addition to the message (default 128;
+                    the entry header and the parameter area, see "tinfo")
+ --slots, -s      - comma separated message sizes (default 64,128,256,512)
+ --line-len, -L   - length of the lines of a long message (default 120, e.g. a
+                    cause chain; 0 for no newlines) -- a record starts at each line
+Only messages written by "erstrace" (ERS issues) are split into continuation
+records; a TLOG()/TLOG_DEBUG() memory entry is truncated at the message size.
+With a record file the source of each message is taken from the record; the
+synthetic mix has 90%% short and 9%% medium TLOG messages and 1%% long ERS issues
+(e.g. cause chains).  For each message size the number of entries, the records
+per message, the history (in messages and, with a record file, in seconds), the
+fraction of all messages which are truncated (TLOG) and which are split (ERS)
+and the measured cost of writing the messages into a circular buffer of such
+entries are printed.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <logging/Logging.hpp>
+
+using dunedaq::logging::Chunk;
+using dunedaq::logging::Recorder;
+using dunedaq::logging::WorkloadHeader;
+using dunedaq::logging::WorkloadRecord;
+
+struct Message
+{
+	uint16_t size;
+	bool     split;				// erstrace: continuation records; else truncated
+};
+
+// 90% short TLOG status messages, 9% medium, 1% long ERS issues (e.g. cause chains)
+static std::vector<Message> synthetic_messages( size_t nn )
+{
+	std::mt19937 gen( 12345 );
+	std::uniform_int_distribution<int> kind( 0, 99 ), shrt( 20, 100 ), med( 100, 400 ), lng( 400, 4000 );
+	std::vector<Message> msgs( nn );
+	for (auto &mm : msgs) {
+		int kk = kind( gen );
+		mm.size  = static_cast<uint16_t>((kk < 90) ? shrt(gen) : (kk < 99) ? med(gen) : lng(gen));
+		mm.split = (kk >= 99);
+	}
+	return msgs;
+}
+
+// the records trace_chunked() writes for the first ss bytes of text
+static size_t message_chunks( const std::string &text, size_t ss, size_t msgmax, std::vector<Chunk> *chunks )
+{
+	if (chunks) chunks->clear();
+	if (ss < msgmax) {
+		if (chunks) chunks->push_back( Chunk{ 0, ss, false } );
+		return 1;
+	}
+	size_t nmax = dunedaq::logging::split_chunks( text.data(), ss, dunedaq::logging::chunk_payload(msgmax,0xffffffff,ss), nullptr );
+	return dunedaq::logging::split_chunks( text.data(), ss, dunedaq::logging::chunk_payload(msgmax,0xffffffff,nmax), chunks );
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *record=nullptr;
+	size_t nmsgs=1000000, memory_mb=64, hdr_size=128, line_len=120;
+	std::vector<size_t> slots{64,128,256,512};
+	int opt_help=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "record",   required_argument, nullptr,   'r' },
+			{ "msgs",     required_argument, nullptr,   'n' },
+			{ "memory",   required_argument, nullptr,   'm' },
+			{ "hdr-size", required_argument, nullptr,   'H' },
+			{ "slots",    required_argument, nullptr,   's' },
+			{ "line-len", required_argument, nullptr,   'L' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hr:n:m:H:s:L:",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                              break;
+		case 'r':           record   =optarg;                        break;
+		case 'n':           nmsgs    =strtoul(optarg,nullptr,0);     break;
+		case 'm':           memory_mb=strtoul(optarg,nullptr,0);     break;
+		case 'H':           hdr_size =strtoul(optarg,nullptr,0);     break;
+		case 'L':           line_len =strtoul(optarg,nullptr,0);     break;
+		case 's':
+			slots.clear();
+			for (char *cp=optarg; *cp; ) {
+				char *ep;
+				slots.push_back( strtoul(cp,&ep,0) );
+				if (ep == cp || slots.back() < 48) { opt_help=1; break; }
+				cp = (*ep == ',') ? ep+1 : ep;
+			}
+			break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help || slots.empty() || memory_mb == 0) { USAGE(); exit(opt_help?0:1); }
+
+	std::vector<Message> msgs;
+	double span_s=0.0;
+	if (record) {
+		FILE *fp=fopen( record, "rb" );
+		WorkloadHeader hdr;
+		if (!fp || fread(&hdr,sizeof(hdr),1,fp) != 1 || memcmp(hdr.magic,"DDLOGREC",8) != 0
+		    || hdr.record_size != sizeof(WorkloadRecord)) {
+			fprintf( stderr, "%s: not a (compatible) logging workload record file\n", record );
+			exit(1);
+		}
+		WorkloadRecord rr;
+		uint64_t first=~0ULL, last=0;
+		while (fread(&rr,sizeof(rr),1,fp) == 1) {
+			msgs.push_back( Message{ rr.size, rr.source == Recorder::k_erstrace } );
+			first = std::min( first, rr.ns );
+			last  = std::max( last,  rr.ns );
+		}
+		fclose( fp );
+		if (msgs.empty()) { fprintf( stderr, "%s: no records\n", record ); exit(1); }
+		span_s = (last-first)/1e9;
+	} else
+		msgs = synthetic_messages( nmsgs );
+
+	std::string text( 0x10000, 'x' );
+	for (size_t ii=line_len; line_len && ii<text.size(); ii+=line_len+1)
+		text[ii] = '\n';
+	std::vector<Chunk> chunks;
+	size_t memory = memory_mb<<20;
+	printf( "%zu messages%s, %zu MB of entries, %zu bytes per entry in addition to the message\n",
+	        msgs.size(), record?" (recorded)":" (synthetic)", memory_mb, hdr_size );
+	printf( "%7s %10s %9s %9s %9s %12s %10s %10s %10s\n", "msgmax", "entries", "recs/msg", "trunc%",
+	        "split%", "hist_msgs", "hist_s", "MB/Mmsg", "ns/msg" );
+	for (size_t msgmax : slots) {
+		size_t entry   = ((hdr_size+msgmax+63)/64)*64;	// whole cache lines
+		size_t entries = memory/entry;
+		size_t records=0, truncated=0, split=0;
+		for (const Message &mm : msgs) {
+			if (mm.size < msgmax || !mm.split)
+				++records;
+			else
+				records += message_chunks( text, mm.size, msgmax, nullptr );
+			truncated += (mm.size >= msgmax && !mm.split);
+			split     += (mm.size >= msgmax &&  mm.split);
+		}
+		double recs_per_msg = static_cast<double>(records)/msgs.size();
+		double hist_msgs    = entries/recs_per_msg;
+
+		// write the messages (as continuation records) into a circular buffer of such entries
+		std::vector<char> ring( entries*entry );
+		size_t slot=0;
+		char pfx[64];
+		auto t0 = std::chrono::steady_clock::now();
+		for (size_t mm=0; mm<msgs.size(); ++mm) {
+			size_t ss = msgs[mm].size;
+			if (ss < msgmax || !msgs[mm].split) {	// TLOG: truncated
+				size_t len = std::min( ss, msgmax-1 );
+				char *ep = &ring[slot*entry];
+				memcpy( ep, &mm, sizeof(mm) );		// stands in for the entry header
+				memcpy( ep+hdr_size, text.data(), len );
+				ep[hdr_size+len] = '\0';
+				slot = (slot+1 == entries) ? 0 : slot+1;
+				continue;
+			}
+			size_t nn = message_chunks( text, ss, msgmax, &chunks );
+			for (size_t kk=0; kk<nn; ++kk) {
+				char *ep = &ring[slot*entry];
+				memcpy( ep, &mm, sizeof(mm) );
+				int plen = snprintf( pfx, sizeof(pfx), "~%zx:%zu/%zu%s~", mm, kk+1, nn, chunks[kk].new_line?"+":"" );
+				memcpy( ep+hdr_size, pfx, plen );
+				memcpy( ep+hdr_size+plen, text.data()+chunks[kk].beg, chunks[kk].len );
+				ep[hdr_size+plen+chunks[kk].len] = '\0';
+				slot = (slot+1 == entries) ? 0 : slot+1;
+			}
+		}
+		double ns = std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now()-t0).count();
+
+		printf( "%7zu %10zu %9.3f %9.3f %9.3f %12.0f %10.1f %10.1f %10.1f\n", msgmax, entries, recs_per_msg,
+		        100.0*truncated/msgs.size(), 100.0*split/msgs.size(), hist_msgs,
+		        (span_s > 0.0) ? hist_msgs*span_s/msgs.size() : 0.0,
+		        recs_per_msg*entry*1e6/(1<<20), ns/msgs.size() );
+	}
+	return (0);
+}   // main
@@ -0,0 +1,121 @@
+/**
+ * @file stack_capture.cxx - measure the cost of the stack capture modes (see
+ *                           logging/detail/StackCapture.hxx)
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2020.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+const char *usage = R"foo(
+  usage: %s [option]    # time the stack capture modes
+example: %s -l 10000 -d 20
+options:
+ --help, -h       - print this help
+ --loops, -l      - loops for each mode
+ --depth, -d      - additional call depth at which the messages are issued
+ --show, -s       - print an example erstrace record text per mode as well
+ers::warning (to "erstrace" only) is timed with stack capture off and raw.
+TLOG_DEBUG(1) slow path messages (to "lstdout", with stdout redirected to
+/dev/null so the printing, incl. the symbolization of full, is measured) are
+timed with off, raw and full.  The results go to stderr.
+)foo""\n";
+#define USAGE() printf( usage, basename(argv[0]), basename(argv[0]) )
+
+#include <getopt.h>             // getopt_long
+#include <libgen.h>             // basename
+#include <chrono>
+#include <string>
+#include <logging/Logging.hpp>
+
+ERS_DECLARE_ISSUE(ERS_EMPTY,                                           // namespace ERS_EMPTY ==> anonymous
+                  TestIssue,                        // issue class name
+                  "Three arg TestIssue - arg 1: " << arg1 << " arg 2: " << arg2 << " arg 3: " << arg3,
+                  ((size_t)arg1) ((int)arg2) ((int)arg3)
+                  )
+
+static int g_loops=10000;
+
+__attribute__((noinline)) static void issue_warnings( int depth )
+{
+	if (depth > 0) {
+		issue_warnings( depth-1 );
+		asm volatile("");			// not a tail call
+		return;
+	}
+	for (int ii=0; ii<g_loops; ++ii)
+		ers::warning( TestIssue( ERS_HERE, 1, 2, ii ) );
+}
+
+__attribute__((noinline)) static void issue_debugs( int depth )
+{
+	if (depth > 0) {
+		issue_debugs( depth-1 );
+		asm volatile("");
+		return;
+	}
+	for (int ii=0; ii<g_loops; ++ii)
+		TLOG_DEBUG(1) << "debug message " << ii;
+}
+
+template <class Fn>
+static double ns_per_msg( Fn fn )
+{
+	auto t0=std::chrono::steady_clock::now();
+	fn();
+	return std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now()-t0).count()/g_loops;
+}
+
+int main(int argc, char *argv[])
+{
+	using namespace dunedaq::logging;
+	int depth=10;
+	int opt_help=0, opt_show=0;
+	while (true) {
+		static struct option long_options[] = {
+			{ "help",     no_argument,       nullptr,   'h' },
+			{ "loops",    required_argument, nullptr,   'l' },
+			{ "depth",    required_argument, nullptr,   'd' },
+			{ "show",     no_argument,       nullptr,   's' },
+			{  nullptr,   0,                 nullptr,    0  }
+		};
+		int opt = getopt_long( argc, argv, "?hl:d:s",long_options, nullptr );
+		if (opt == -1) break;
+		switch (opt) {
+		case '?': case 'h': opt_help=1;                                           break;
+		case 'l':           g_loops =static_cast<int>(strtoul(optarg,nullptr,0)); break;
+		case 'd':           depth   =static_cast<int>(strtoul(optarg,nullptr,0)); break;
+		case 's':           opt_show=1;                                           break;
+		default:
+			opt_help=1;
+		}
+	}
+	if (opt_help) { USAGE(); exit(0); }
+
+	// only the TRACE memory destination so the capture cost is not hidden by the console
+	setenv("DUNEDAQ_ERS_WARNING","erstrace",1);
+	setenv("DUNEDAQ_ERS_DEBUG","lstdout",1);
+	setenv("DUNEDAQ_ERS_DEBUG_LEVEL","1",1);	// the slow path of TLOG_DEBUG(0..1)
+	Logging::setup("test", "stack_capture");
+	StackPolicy::warm_up();
+	if (!freopen("/dev/null","w",stdout)) { perror("/dev/null"); exit(1); }
+
+	const char *names[] = {"off","raw","full"};
+	for (StackMode mode : {StackMode::Off, StackMode::Raw}) {
+		StackPolicy::set( ers::Warning, mode );
+		double ns = ns_per_msg( [depth]() { issue_warnings( depth ); } );
+		fprintf( stderr, "stack %-5s %10.1f ns/warning (erstrace)\n", names[static_cast<int>(mode)], ns );
+		if (opt_show) {
+			std::string msg="example record text:";
+			append_stack( msg, mode );
+			fprintf( stderr, "%s\n", msg.c_str() );
+		}
+	}
+	for (StackMode mode : {StackMode::Off, StackMode::Raw, StackMode::Full}) {
+		StackPolicy::set( ers::Debug, mode );
+		double ns = ns_per_msg( [depth]() { issue_debugs( depth ); } );
+		fprintf( stderr, "stack %-5s %10.1f ns/TLOG_DEBUG (slow path, lstdout)\n", names[static_cast<int>(mode)], ns );
+	}
+	fflush( stdout );
+	return (0);
+}   // main